@@ -1,4 +1,5 @@
 
+#include <climits>
 #include <exception>
 #include <vector>
 #include <string>
@@ -12,6 +13,8 @@
 #include <future>
 
 #include "App.h"
+#include "Benchmark.h"
+#include "HeldKarp.h"
 using namespace std;
 
 static void clear_screen() {
@@ -130,9 +133,24 @@ void App::mainMenu() {
     // Print Data Selection Results
     runMenu("City Manager", {
             {'1', "Backtracking Algorithm"},
+            {'b', "Branch and Bound Algorithm"},
             {'2', "Triangular Approximation Heuristic"},
+            {'c', "Christofides Algorithm"},
             {'3', "Nearest Neighbor Algorithm"},
+            {'m', "Nearest Neighbor Algorithm (Multi-Start)"},
             {'4', "Greedy Algorithm"},
+            {'5', "Nearest Neighbor Algorithm (Candidate Lists)"},
+            {'6', "Greedy Algorithm (Candidate Lists)"},
+            {'7', "Nearest Neighbor Algorithm (Spatial Index)"},
+            {'f', "Hilbert Curve Heuristic (Space-Filling Curve)"},
+            {'8', "2-opt Local Search"},
+            {'9', "Local Search (2-opt, Or-opt, 3-opt)"},
+            {'l', "Lin-Kernighan Local Search"},
+            {'i', "Iterated Local Search (Time Budget)"},
+            {'p', "Parallel Island Model (Time Budget)"},
+            {'h', "Held-Karp Algorithm (Exact)"},
+            {'k', "Candidate List Size"},
+            {'t', "Thread Count"},
             {'d', "Data Selection"},
             {'x', "Exit App"}
     }, [this](char choice) -> bool {
@@ -149,6 +167,18 @@ void App::mainMenu() {
                 }
                 cout << "Time spent: " << fixed << setprecision(3) << ((double) duration.count() / 1000) << "s" << endl;
             } break;
+            case 'b': {
+                cout << "Branch and Bound Algorithm Solution Loading..." << endl;
+                auto start = chrono::high_resolution_clock::now();
+                CityNetwork::Path path = cityNet.branchAndBound();
+                auto duration = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start);
+                if (path.isValid()) {
+                    cout << "Distance: " << fixed << setprecision(2) << path.getDistance() << endl;
+                } else {
+                    cout << "No path found!" << endl;
+                }
+                cout << "Time spent: " << fixed << setprecision(3) << ((double) duration.count() / 1000) << "s" << endl;
+            } break;
             case '2': {
                 cout << "Triangular Approximation Heuristic Solution Loading..." << endl;
                 auto start = chrono::high_resolution_clock::now();
@@ -156,6 +186,20 @@ void App::mainMenu() {
                 auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
                 if (path.isValid()) {
                     cout << "Distance: " << fixed << setprecision(2) << path.getDistance() << endl;
+                    printGap(cout, cityNet, path);
+                } else {
+                    cout << "No path found!" << endl;
+                }
+                cout << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s" << endl;
+            } break;
+            case 'c': {
+                cout << "Christofides Algorithm Solution Loading..." << endl;
+                auto start = chrono::high_resolution_clock::now();
+                CityNetwork::Path path = cityNet.christofides();
+                auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+                if (path.isValid()) {
+                    cout << "Distance: " << fixed << setprecision(2) << path.getDistance() << endl;
+                    printGap(cout, cityNet, path);
                 } else {
                     cout << "No path found!" << endl;
                 }
@@ -168,6 +212,24 @@ void App::mainMenu() {
                 auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
                 if (path.isValid()) {
                     cout << "Distance: " << fixed << setprecision(2) << path.getDistance() << endl;
+                    printGap(cout, cityNet, path);
+                } else {
+                    cout << "No path found!" << endl;
+                }
+                cout << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s" << endl;
+            } break;
+            case 'm': {
+                string count = getDoubleString("Number of start nodes (0 for all, x to cancel):", "Invalid number. Try Again.", [](double value) {
+                    return value >= 0 && value <= INT_MAX && value == floor(value);
+                });
+                if (count == "x") break;
+                cout << "Multi-Start Nearest Neighbor Algorithm Solution Loading..." << endl;
+                auto start = chrono::high_resolution_clock::now();
+                CityNetwork::Path path = cityNet.multiStartNearestNeighbor((unsigned int) stod(count));
+                auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+                if (path.isValid()) {
+                    cout << "Distance: " << fixed << setprecision(2) << path.getDistance() << endl;
+                    printGap(cout, cityNet, path);
                 } else {
                     cout << "No path found!" << endl;
                 }
@@ -180,11 +242,198 @@ void App::mainMenu() {
                 auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
                 if (path.isValid()) {
                     cout << "Distance: " << fixed << setprecision(2) << path.getDistance() << endl;
+                    printGap(cout, cityNet, path);
+                } else {
+                    cout << "No path found!" << endl;
+                }
+                cout << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s" << endl;
+            } break;
+            case '5': {
+                cout << "Nearest Neighbor Algorithm (Candidate Lists) Solution Loading..." << endl;
+                auto start = chrono::high_resolution_clock::now();
+                CityNetwork::Path path = cityNet.candidateNearestNeighbor();
+                auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+                if (path.isValid()) {
+                    cout << "Distance: " << fixed << setprecision(2) << path.getDistance() << endl;
+                    printGap(cout, cityNet, path);
+                } else {
+                    cout << "No path found!" << endl;
+                }
+                cout << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s" << endl;
+            } break;
+            case '6': {
+                cout << "Greedy Algorithm (Candidate Lists) Solution Loading..." << endl;
+                auto start = chrono::high_resolution_clock::now();
+                CityNetwork::Path path = cityNet.candidateGreedyAlgorithm();
+                auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+                if (path.isValid()) {
+                    cout << "Distance: " << fixed << setprecision(2) << path.getDistance() << endl;
+                    printGap(cout, cityNet, path);
+                } else {
+                    cout << "No path found!" << endl;
+                }
+                cout << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s" << endl;
+            } break;
+            case '7': {
+                cout << "Nearest Neighbor Algorithm (Spatial Index) Solution Loading..." << endl;
+                auto start = chrono::high_resolution_clock::now();
+                CityNetwork::Path path = cityNet.spatialNearestNeighbor();
+                auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+                if (path.isValid()) {
+                    cout << "Distance: " << fixed << setprecision(2) << path.getDistance() << endl;
+                    printGap(cout, cityNet, path);
+                } else {
+                    cout << "No path found!" << endl;
+                }
+                cout << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s" << endl;
+            } break;
+            case 'f': {
+                cout << "Hilbert Curve Heuristic Solution Loading..." << endl;
+                auto start = chrono::high_resolution_clock::now();
+                CityNetwork::Path path = cityNet.hilbertCurve();
+                auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+                if (path.isValid()) {
+                    cout << "Distance: " << fixed << setprecision(2) << path.getDistance() << endl;
+                    printGap(cout, cityNet, path);
                 } else {
                     cout << "No path found!" << endl;
                 }
                 cout << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s" << endl;
             } break;
+            case '8': {
+                CityNetwork::Path startPath = getStartingTour();
+                if (!startPath.isValid()) {
+                    cout << "No starting path found!" << endl;
+                    break;
+                }
+                cout << "2-opt Local Search Solution Loading..." << endl;
+                auto start = chrono::high_resolution_clock::now();
+                CityNetwork::Path path = cityNet.twoOpt(startPath);
+                auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+                cout << "Distance before: " << fixed << setprecision(2) << startPath.getDistance() << endl;
+                cout << "Distance after: " << fixed << setprecision(2) << path.getDistance()
+                     << " (-" << 100 * (1 - path.getDistance() / startPath.getDistance()) << "%)" << endl;
+                printGap(cout, cityNet, path);
+                cout << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s" << endl;
+            } break;
+            case '9': {
+                CityNetwork::Path startPath = getStartingTour();
+                if (!startPath.isValid()) {
+                    cout << "No starting path found!" << endl;
+                    break;
+                }
+                cout << vertical << " Moves: 1 - 2-opt, 2 - Or-opt, 3 - 2-opt + Or-opt, 4 - 2-opt + Or-opt + 3-opt" << endl;
+                char movesChoice = getInput("Choice:", "Invalid Choice. Try Again.", unordered_set<char>{'1', '2', '3', '4'});
+                unsigned int moves = movesChoice == '1' ? CityNetwork::moveTwoOpt
+                                   : movesChoice == '2' ? CityNetwork::moveOrOpt
+                                   : movesChoice == '3' ? CityNetwork::moveTwoOpt | CityNetwork::moveOrOpt
+                                   : CityNetwork::moveTwoOpt | CityNetwork::moveOrOpt | CityNetwork::moveThreeOpt;
+                cout << vertical << " Policy: f - First Improvement, b - Best Improvement" << endl;
+                char policyChoice = getInput("Choice:", "Invalid Choice. Try Again.", unordered_set<char>{'f', 'b'});
+                LocalSearch::Policy policy = policyChoice == 'f' ? LocalSearch::firstImprovement : LocalSearch::bestImprovement;
+                cout << "Local Search Solution Loading..." << endl;
+                auto start = chrono::high_resolution_clock::now();
+                CityNetwork::Path path = cityNet.localSearch(startPath, moves, policy);
+                auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+                cout << "Distance before: " << fixed << setprecision(2) << startPath.getDistance() << endl;
+                cout << "Distance after: " << fixed << setprecision(2) << path.getDistance()
+                     << " (-" << 100 * (1 - path.getDistance() / startPath.getDistance()) << "%)" << endl;
+                printGap(cout, cityNet, path);
+                cout << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s" << endl;
+            } break;
+            case 'l': {
+                CityNetwork::Path startPath = getStartingTour();
+                if (!startPath.isValid()) {
+                    cout << "No starting path found!" << endl;
+                    break;
+                }
+                cout << "Lin-Kernighan Local Search Solution Loading..." << endl;
+                auto start = chrono::high_resolution_clock::now();
+                CityNetwork::Path path = cityNet.linKernighan(startPath);
+                auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+                cout << "Distance before: " << fixed << setprecision(2) << startPath.getDistance() << endl;
+                cout << "Distance after: " << fixed << setprecision(2) << path.getDistance()
+                     << " (-" << 100 * (1 - path.getDistance() / startPath.getDistance()) << "%)" << endl;
+                printGap(cout, cityNet, path);
+                cout << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s" << endl;
+            } break;
+            case 'i': {
+                CityNetwork::Path startPath = getStartingTour();
+                if (!startPath.isValid()) {
+                    cout << "No starting path found!" << endl;
+                    break;
+                }
+                string seconds = getDoubleString("Time budget in seconds (x to cancel):", "Invalid time. Try Again.", [](double value) {
+                    return value > 0;
+                });
+                if (seconds == "x") break;
+                cout << "Iterated Local Search Solution Loading..." << endl;
+                auto start = chrono::high_resolution_clock::now();
+                CityNetwork::Path path = cityNet.iteratedLocalSearch(startPath, stod(seconds), [](const IteratedLocalSearch::Progress& progress) {
+                    cout << vertical << " [" << fixed << setprecision(2) << setw(7) << progress.elapsed << "s] Best: "
+                         << progress.bestLength << " (" << progress.iterations << " kicks, " << progress.improvements << " improving)" << endl;
+                    return true;
+                });
+                auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+                cout << "Distance before: " << fixed << setprecision(2) << startPath.getDistance() << endl;
+                cout << "Distance after: " << fixed << setprecision(2) << path.getDistance()
+                     << " (-" << 100 * (1 - path.getDistance() / startPath.getDistance()) << "%)" << endl;
+                printGap(cout, cityNet, path);
+                cout << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s" << endl;
+            } break;
+            case 'p': {
+                string seconds = getDoubleString("Time budget in seconds (x to cancel):", "Invalid time. Try Again.", [](double value) {
+                    return value > 0;
+                });
+                if (seconds == "x") break;
+                cout << "Island Model Solution Loading (" << cityNet.getThreadCount() << " islands)..." << endl;
+                auto start = chrono::high_resolution_clock::now();
+                IslandModel::Result result;
+                CityNetwork::Path path = cityNet.islandSearch(stod(seconds), 0, &result);
+                auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+                if (path.isValid()) {
+                    cout << "Distance: " << fixed << setprecision(2) << path.getDistance() << endl;
+                    printGap(cout, cityNet, path);
+                    cout << "Tours evaluated: " << result.kicks << " (" << fixed << setprecision(0) << (double) result.kicks / result.seconds
+                         << " per second), " << result.adoptions << " exchanges" << endl;
+                } else {
+                    cout << "No path found!" << endl;
+                }
+                cout << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s" << endl;
+            } break;
+            case 'h': {
+                if (cityNet.getNodeCount() > HeldKarp::maxNodes) {
+                    cout << "Too many nodes (at most " << HeldKarp::maxNodes << ")!" << endl;
+                    break;
+                }
+                cout << "Memory needed: " << fixed << setprecision(1)
+                     << (double) HeldKarp::memoryUsage((int) cityNet.getNodeCount()) / (1 << 20) << " MB" << endl;
+                cout << "Held-Karp Algorithm Solution Loading..." << endl;
+                auto start = chrono::high_resolution_clock::now();
+                CityNetwork::Path path = cityNet.heldKarp();
+                auto duration = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start);
+                if (path.isValid()) {
+                    cout << "Distance: " << fixed << setprecision(2) << path.getDistance() << endl;
+                } else {
+                    cout << "No path found!" << endl;
+                }
+                cout << "Time spent: " << fixed << setprecision(3) << ((double) duration.count() / 1000) << "s" << endl;
+            } break;
+            case 'k': {
+                cout << vertical << " Current candidate list size: " << cityNet.getCandidateCount() << endl;
+                string count = getDoubleString("Candidate list size (x to cancel):", "Invalid size. Try Again.", [](double value) {
+                    return value >= 1 && value <= CityNetwork::maxCandidateCount && value == floor(value);
+                });
+                // A node has at most V - 1 neighbours.
+                if (count != "x") cityNet.setCandidateCount((int) min(stod(count), max((double) cityNet.getNodeCount() - 1, 1.0)));
+            } break;
+            case 't': {
+                cout << vertical << " Current thread count: " << cityNet.getThreadCount() << endl;
+                string count = getDoubleString("Thread count (x to cancel):", "Invalid thread count. Try Again.", [](double value) {
+                    return value >= 1 && value <= CityNetwork::maxThreadCount && value == floor(value);
+                });
+                if (count != "x") cityNet.setThreadCount((unsigned int) stod(count));
+            } break;
             case 'd': dataSelectionMenu(); return true;
             case 'x': return false;
         }
@@ -192,6 +441,34 @@ void App::mainMenu() {
     }, false, false);
 }
 
+void App::printGap(ostream& out, CityNetwork& network, const CityNetwork::Path& path) {
+    if (!path.isValid()) return;
+    const double gap = network.optimalityGap(path);
+    if (isnan(gap)) out << "Optimality gap: unknown (no lower bound)" << '\n';
+    else out << "Optimality gap: at most " << fixed << setprecision(2) << gap << "% (lower bound: " << network.lowerBound() << ")" << '\n';
+}
+
+CityNetwork::Path App::getStartingTour() {
+    cout << vertical << " Starting tour: 2 - Triangular Approximation, 3 - Nearest Neighbor, 4 - Greedy," << endl
+         << vertical << " 5 - Nearest Neighbor (Candidate Lists), 6 - Greedy (Candidate Lists), 7 - Nearest Neighbor (Spatial Index)," << endl
+         << vertical << " f - Hilbert Curve" << endl;
+    char choice = getInput("Choice:", "Invalid Choice. Try Again.", unordered_set<char>{'2', '3', '4', '5', '6', '7', 'f'});
+    auto start = chrono::high_resolution_clock::now();
+    CityNetwork::Path path;
+    switch (choice) {
+        case '2': path = cityNet.triangularApproximation(); break;
+        case '3': path = cityNet.nearestNeighbor(); break;
+        case '4': path = cityNet.greedyAlgorithm(); break;
+        case '5': path = cityNet.candidateNearestNeighbor(); break;
+        case '6': path = cityNet.candidateGreedyAlgorithm(); break;
+        case 'f': path = cityNet.hilbertCurve(); break;
+        default: path = cityNet.spatialNearestNeighbor(); break;
+    }
+    auto duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+    cout << "Starting tour time: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s" << endl;
+    return path;
+}
+
 // =================== //
 // DATA SELECTION MENU //
 // =================== //
@@ -211,13 +488,48 @@ void App::getAll(const string& outFile, bool fullPaths) {
         out << cityNetwork << endl;
         out << "Initialization time: " << ((double) duration.count() / 1000000)  << "s" << endl;
         out << str << " Data:\n" << endl;
-        CityNetwork::Path path;
+        out << "Held-Karp Lower Bound:" << endl;
+        start = chrono::high_resolution_clock::now();
+        const double lowerBound = cityNetwork.lowerBound();
+        duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+        out << "Lower bound: " << fixed << setprecision(2) << lowerBound << '\n';
+        out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
+        CityNetwork::Path path, trianglePath, greedyPath;
+        if (cityNetwork.getNodeCount() <= 20) { // Larger graphs take too long (and too much memory) here.
+            out << "Held-Karp Algorithm:" << endl;
+            out << "Memory used: " << fixed << setprecision(1)
+                << (double) HeldKarp::memoryUsage((int) cityNetwork.getNodeCount()) / (1 << 20) << " MB" << endl;
+            start = chrono::high_resolution_clock::now();
+            path = cityNetwork.heldKarp();
+            duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+            if (fullPaths) out << path << '\n';
+            else out << "Distance: " << fixed << setprecision(2) << path.getDistance() << '\n';
+            printGap(out, cityNetwork, path);
+            out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
+            out << "Branch and Bound Algorithm:" << endl;
+            start = chrono::high_resolution_clock::now();
+            path = cityNetwork.branchAndBound();
+            duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+            if (fullPaths) out << path << '\n';
+            else out << "Distance: " << fixed << setprecision(2) << path.getDistance() << '\n';
+            printGap(out, cityNetwork, path);
+            out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
+        }
         out << "Triangular Approximation Heuristic:" << endl;
         start = chrono::high_resolution_clock::now();
-        path = cityNetwork.triangularApproximation();
+        path = trianglePath = cityNetwork.triangularApproximation();
+        duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+        if (fullPaths) out << path << '\n';
+        else out << "Distance: " << fixed << setprecision(2) << path.getDistance() << '\n';
+        printGap(out, cityNetwork, path);
+        out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
+        out << "Christofides Algorithm:" << endl;
+        start = chrono::high_resolution_clock::now();
+        path = cityNetwork.christofides();
         duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
         if (fullPaths) out << path << '\n';
         else out << "Distance: " << fixed << setprecision(2) << path.getDistance() << '\n';
+        printGap(out, cityNetwork, path);
         out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
         out << "Nearest Neighbor Algorithm:" << endl;
         start = chrono::high_resolution_clock::now();
@@ -225,13 +537,73 @@ void App::getAll(const string& outFile, bool fullPaths) {
         duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
         if (fullPaths) out << path << '\n';
         else out << "Distance: " << fixed << setprecision(2) << path.getDistance() << '\n';
+        printGap(out, cityNetwork, path);
+        out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
+        out << "Nearest Neighbor Algorithm (Multi-Start, 100 start nodes):" << endl;
+        start = chrono::high_resolution_clock::now();
+        path = cityNetwork.multiStartNearestNeighbor(100);
+        duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+        if (fullPaths) out << path << '\n';
+        else out << "Distance: " << fixed << setprecision(2) << path.getDistance() << '\n';
+        printGap(out, cityNetwork, path);
         out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
         out << "Greedy Algorithm:" << endl;
         start = chrono::high_resolution_clock::now();
-        path = cityNetwork.greedyAlgorithm();
+        path = greedyPath = cityNetwork.greedyAlgorithm();
+        duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+        if (fullPaths) out << path << '\n';
+        else out << "Distance: " << fixed << setprecision(2) << path.getDistance() << '\n';
+        printGap(out, cityNetwork, path);
+        out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
+        out << "Nearest Neighbor Algorithm (Candidate Lists):" << endl;
+        start = chrono::high_resolution_clock::now();
+        path = cityNetwork.candidateNearestNeighbor();
         duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
         if (fullPaths) out << path << '\n';
         else out << "Distance: " << fixed << setprecision(2) << path.getDistance() << '\n';
+        printGap(out, cityNetwork, path);
+        out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
+        out << "Nearest Neighbor Algorithm (Spatial Index):" << endl;
+        start = chrono::high_resolution_clock::now();
+        path = cityNetwork.spatialNearestNeighbor();
+        duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+        if (fullPaths) out << path << '\n';
+        else out << "Distance: " << fixed << setprecision(2) << path.getDistance() << '\n';
+        printGap(out, cityNetwork, path);
+        out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
+        out << "Hilbert Curve Heuristic:" << endl;
+        start = chrono::high_resolution_clock::now();
+        path = cityNetwork.hilbertCurve();
+        duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+        if (fullPaths) out << path << '\n';
+        else out << "Distance: " << fixed << setprecision(2) << path.getDistance() << '\n';
+        printGap(out, cityNetwork, path);
+        out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
+        out << "Greedy Algorithm (Candidate Lists):" << endl;
+        start = chrono::high_resolution_clock::now();
+        path = cityNetwork.candidateGreedyAlgorithm();
+        duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+        if (fullPaths) out << path << '\n';
+        else out << "Distance: " << fixed << setprecision(2) << path.getDistance() << '\n';
+        printGap(out, cityNetwork, path);
+        out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
+        out << "2-opt Local Search (from Triangular Approximation):" << endl;
+        start = chrono::high_resolution_clock::now();
+        path = cityNetwork.twoOpt(trianglePath);
+        duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+        if (fullPaths) out << path << '\n';
+        else out << "Distance before: " << fixed << setprecision(2) << trianglePath.getDistance() << '\n'
+                 << "Distance after: " << fixed << setprecision(2) << path.getDistance() << '\n';
+        printGap(out, cityNetwork, path);
+        out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
+        out << "Lin-Kernighan Local Search (from Greedy Algorithm):" << endl;
+        start = chrono::high_resolution_clock::now();
+        path = cityNetwork.linKernighan(greedyPath);
+        duration = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start);
+        if (fullPaths) out << path << '\n';
+        else out << "Distance before: " << fixed << setprecision(2) << greedyPath.getDistance() << '\n'
+                 << "Distance after: " << fixed << setprecision(2) << path.getDistance() << '\n';
+        printGap(out, cityNetwork, path);
         out << "Time spent: " << fixed << setprecision(6) << ((double) duration.count() / 1000000)  << "s\n" << endl;
     }
 }
@@ -267,6 +639,99 @@ void App::dataSelectionMenu() {
                 calc = true;
                 break;
             }
+            if (pathChosen == "$LAZY") {
+                // Cycle the edge mode of coordinate datasets: eager -> on demand -> on demand and cached.
+                if (!cityNet.getLazyEdges()) cityNet.setLazyEdges(true, false);
+                else if (!cityNet.getMemoizeEdges()) cityNet.setLazyEdges(true, true);
+                else cityNet.setLazyEdges(false);
+                cout << vertical << " Missing edges of coordinate datasets: "
+                     << (!cityNet.getLazyEdges() ? "precomputed" : cityNet.getMemoizeEdges() ? "computed on demand (cached)" : "computed on demand") << endl;
+                continue;
+            }
+            if (pathChosen == "$HAVERSINE") {
+                // Compare the haversine implementations on the real graphs.
+                ofstream out(projectPath + "haversine_benchmark.txt");
+                Benchmark::haversine(out, projectPath);
+                clear_screen();
+                cout << "Benchmarked haversine distances and saved to haversine_benchmark.txt" << endl;
+                calc = true;
+                break;
+            }
+            if (pathChosen == "$EXACT") {
+                // Compare the branch and bound on different thread counts.
+                ofstream out(projectPath + "exact_scaling_benchmark.txt");
+                Benchmark::exactScaling(out, projectPath);
+                clear_screen();
+                cout << "Benchmarked the branch and bound and saved to exact_scaling_benchmark.txt" << endl;
+                calc = true;
+                break;
+            }
+            if (pathChosen == "$CHRISTOFIDES") {
+                // Compare Christofides' algorithm with the triangular approximation.
+                ofstream out(projectPath + "christofides_benchmark.txt");
+                Benchmark::christofides(out, projectPath);
+                clear_screen();
+                cout << "Benchmarked Christofides' algorithm and saved to christofides_benchmark.txt" << endl;
+                calc = true;
+                break;
+            }
+            if (pathChosen == "$GEN") {
+                // Write a synthetic coordinate dataset to benchmark the heuristics for huge graphs.
+                string count = getDoubleString("Node count (x to cancel):", "Invalid node count. Try Again.", [](double value) {
+                    return value >= 2 && value <= 10000000 && value == floor(value);
+                });
+                if (count == "x") continue;
+                const int nodeCount = (int) stod(count);
+                const string directory = "graphs-synthetic/nodes_" + to_string(nodeCount) + "/";
+                Benchmark::generateNodes(projectPath + directory + "nodes.csv", nodeCount);
+                cout << vertical << " Saved to " << directory << " (use $LAZY before loading large sets)" << endl;
+                continue;
+            }
+            if (pathChosen == "$HILBERT") {
+                // Time the Hilbert curve tour on synthetic datasets of 100k to 1M nodes.
+                ofstream out(projectPath + "hilbert_benchmark.txt");
+                Benchmark::spaceFillingCurve(out, projectPath);
+                clear_screen();
+                cout << "Benchmarked the Hilbert curve tour and saved to hilbert_benchmark.txt" << endl;
+                calc = true;
+                break;
+            }
+            if (pathChosen == "$ISLANDS") {
+                // Compare the island model on different island counts.
+                ofstream out(projectPath + "island_benchmark.txt");
+                Benchmark::islands(out, projectPath);
+                clear_screen();
+                cout << "Benchmarked the island model and saved to island_benchmark.txt" << endl;
+                calc = true;
+                break;
+            }
+            if (pathChosen == "$SERVICE") {
+                // Compare the solver service on different thread counts.
+                ofstream out(projectPath + "service_benchmark.txt");
+                Benchmark::solverService(out, projectPath);
+                clear_screen();
+                cout << "Benchmarked the solver service and saved to service_benchmark.txt" << endl;
+                calc = true;
+                break;
+            }
+            if (pathChosen == "$LOCAL") {
+                // Compare the local search moves and policies on the extra graphs.
+                ofstream out(projectPath + "local_search_benchmark.txt");
+                Benchmark::localSearch(out, projectPath);
+                clear_screen();
+                cout << "Benchmarked the local search and saved to local_search_benchmark.txt" << endl;
+                calc = true;
+                break;
+            }
+            if (pathChosen == "$LOAD") {
+                // Compare the CSV loaders on the extra graphs.
+                ofstream out(projectPath + "load_benchmark.txt");
+                Benchmark::loading(out, projectPath);
+                clear_screen();
+                cout << "Benchmarked CSV loading and saved to load_benchmark.txt" << endl;
+                calc = true;
+                break;
+            }
             pathChosenFull = projectPath + pathChosen;
             for (char& c : pathChosenFull) if (c == '/') c = '\\';
             if (filesystem::is_directory(pathChosenFull)) {
@@ -280,10 +745,7 @@ void App::dataSelectionMenu() {
         if (calc) continue;
         bool allGood = true;
         if (filesystem::is_directory(pathChosenFull)){
-            if (!filesystem::exists(pathChosenFull + "edges.csv")) {
-                allGood = false;
-                cout << vertical << " edges.csv not found in folder given!" << endl;
-            }
+            // edges.csv is optional: without it, every edge is computed from the coordinates.
             if (!filesystem::exists(pathChosenFull + "nodes.csv")){
                 allGood = false;
                 cout << vertical << " nodes.csv not found in folder given!" << endl;
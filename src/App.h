@@ -137,6 +137,20 @@ class App {
      * @details The time complexity of this function depends on the complexity of the initializeData function in the cityNet object.
      */
     void initializeData();
+    /**
+     * @brief Asks the user for a heuristic and runs it, to get a starting tour for the local search.
+     * @return The tour found by the heuristic chosen.
+     * @details The time complexity of this function is the one of the heuristic chosen.
+     */
+    CityNetwork::Path getStartingTour();
+    /**
+     * @brief Prints how far from optimal a tour can be, by comparing it with the lower bound of the network.
+     * @param out The stream to print to.
+     * @param network The city network the tour belongs to.
+     * @param path The tour (nothing is printed if it isn't valid).
+     * @details The lower bound is computed on the first call for the network (see CityNetwork::lowerBound()).
+     */
+    static void printGap(std::ostream& out, CityNetwork& network, const CityNetwork::Path& path);
     /**
      * @brief Runs the heuristic algorithms for all testing graphs.
      * @param outFile The filename of the file where the output is going to go.
@@ -0,0 +1,415 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "CSVReader.h"
+#include "CityNetwork.h"
+#include "HaversineKernel.h"
+#include "LocalSearch.h"
+#include "PerfectMatching.h"
+#include "SolverService.h"
+
+using namespace std;
+
+static const char* const realGraphs[] = {"graphs-real/graph1/", "graphs-real/graph2/", "graphs-real/graph3/"};
+static const char* const extraGraphs[] = {"graphs-extra/edges_25.csv", "graphs-extra/edges_50.csv", "graphs-extra/edges_75.csv", "graphs-extra/edges_100.csv", "graphs-extra/edges_200.csv", "graphs-extra/edges_300.csv", "graphs-extra/edges_400.csv", "graphs-extra/edges_500.csv", "graphs-extra/edges_600.csv", "graphs-extra/edges_700.csv", "graphs-extra/edges_800.csv", "graphs-extra/edges_900.csv"};
+
+namespace {
+    struct EdgeRecord {
+        int origin;
+        int dest;
+        double dist;
+        bool operator==(const EdgeRecord& other) const {
+            return origin == other.origin && dest == other.dest && dist == other.dist;
+        }
+    };
+
+    /**
+     * @brief Runs f a few times and returns the fastest run, in seconds.
+     */
+    template <typename Function>
+    double bestOf(int runs, Function f) {
+        double best = INFINITY;
+        for (int i = 0; i < runs; i++) {
+            auto start = chrono::high_resolution_clock::now();
+            f();
+            best = min(best, chrono::duration<double>(chrono::high_resolution_clock::now() - start).count());
+        }
+        return best;
+    }
+}
+
+void Benchmark::loading(ostream& out, const string& projectPath) {
+    const int runs = 5;
+    out << "CSV Loading (best of " << runs << " runs):\n" << endl;
+    for (const char* str : extraGraphs) {
+        const string fullPath = projectPath + str;
+        if (!filesystem::exists(fullPath)) continue;
+        vector<EdgeRecord> oldRecords, newRecords;
+        double oldTime = bestOf(runs, [&]() {
+            oldRecords.clear();
+            CSV csv = CSVReader::read(fullPath);
+            for (const CSVLine& line : csv)
+                oldRecords.push_back({stoi(line[0]), stoi(line[1]), stod(line[2])});
+        });
+        double newTime = bestOf(runs, [&]() {
+            newRecords.clear();
+            MappedFile file(fullPath);
+            CSVReader::forEachLine(file, [&](const CSVFields& line) {
+                newRecords.push_back({CSVReader::toInt(line[0]), CSVReader::toInt(line[1]), CSVReader::toDouble(line[2])});
+            });
+        });
+        out << str << " (" << newRecords.size() << " lines)\n"
+            << "CSVReader::read:        " << fixed << setprecision(6) << oldTime << "s\n"
+            << "CSVReader::forEachLine: " << fixed << setprecision(6) << newTime << "s\n"
+            << "Speedup: " << fixed << setprecision(2) << oldTime / newTime << "x"
+            << (oldRecords == newRecords ? "" : " (RECORDS DIFFER!)") << '\n' << endl;
+    }
+}
+
+void Benchmark::haversine(ostream& out, const string& projectPath) {
+    const int runs = 3;
+    out << "Haversine Distances (all pairs, best of " << runs << " runs, kernel uses " << HaversineKernel::getInstructionSet() << "):\n" << endl;
+    for (const char* str : realGraphs) {
+        const string nodesFile = projectPath + str + "nodes.csv";
+        if (!filesystem::exists(nodesFile)) continue;
+        vector<CityNetwork::Node> nodes;
+        vector<double> lats, lons;
+        MappedFile file(nodesFile);
+        bool firstLine = true;
+        CSVReader::forEachLine(file, [&](const CSVFields& line) {
+            if (firstLine) { firstLine = false; return; }
+            nodes.emplace_back((int) nodes.size(), CSVReader::toDouble(line[1]), CSVReader::toDouble(line[2]));
+            lats.push_back(nodes.back().lat);
+            lons.push_back(nodes.back().lon);
+        });
+        const int n = (int) nodes.size();
+        const double pairs = (double) n * (n - 1) / 2;
+        vector<double> row(n);
+        volatile double checksum = 0; // Keeps the timed loops from being optimized away.
+        double operatorTime = bestOf(runs, [&]() {
+            for (int i = 1; i < n; i++) {
+                for (int j = 0; j < i; j++) row[j] = nodes[j] - nodes[i];
+                checksum = checksum + row[0];
+            }
+        });
+        HaversineKernel kernel;
+        double setupTime = bestOf(runs, [&]() { kernel.assign(lats, lons); });
+        double scalarTime = bestOf(runs, [&]() {
+            for (int i = 1; i < n; i++) {
+                kernel.distancesScalar(i, 0, i, row.data());
+                checksum = checksum + row[0];
+            }
+        });
+        double kernelTime = bestOf(runs, [&]() {
+            for (int i = 1; i < n; i++) {
+                kernel.distances(i, 0, i, row.data());
+                checksum = checksum + row[0];
+            }
+        });
+        double maxError = 0;
+        for (int i = 1; i < n; i++) {
+            kernel.distances(i, 0, i, row.data());
+            for (int j = 0; j < i; j++) {
+                double expected = nodes[j] - nodes[i];
+                if (expected > 0) maxError = max(maxError, fabs(row[j] - expected) / expected);
+            }
+        }
+        out << str << " (" << n << " nodes, " << fixed << setprecision(0) << pairs << " pairs)\n"
+            << "Node::operator-:         " << fixed << setprecision(6) << operatorTime << "s ("
+            << setprecision(1) << pairs / operatorTime / 1e6 << "M pairs/s)\n"
+            << "Kernel setup:            " << setprecision(6) << setupTime << "s\n"
+            << "Kernel (scalar):         " << setprecision(6) << scalarTime << "s ("
+            << setprecision(1) << pairs / scalarTime / 1e6 << "M pairs/s)\n"
+            << "Kernel (" << HaversineKernel::getInstructionSet() << "):" << string(max(1, 15 - (int) strlen(HaversineKernel::getInstructionSet())), ' ')
+            << setprecision(6) << kernelTime << "s (" << setprecision(1) << pairs / kernelTime / 1e6 << "M pairs/s)\n"
+            << "Speedup over operator-: " << setprecision(2) << operatorTime / kernelTime << "x\n"
+            << "Max relative difference: " << scientific << setprecision(2) << maxError << defaultfloat << '\n' << endl;
+    }
+}
+
+void Benchmark::localSearch(ostream& out, const string& projectPath) {
+    const struct {
+        const char* name;
+        unsigned int moves;
+    } configs[] = {
+        {"2-opt", CityNetwork::moveTwoOpt},
+        {"Or-opt", CityNetwork::moveOrOpt},
+        {"2-opt + Or-opt", CityNetwork::moveTwoOpt | CityNetwork::moveOrOpt},
+        {"2-opt + Or-opt + 3-opt", CityNetwork::moveTwoOpt | CityNetwork::moveOrOpt | CityNetwork::moveThreeOpt},
+    };
+    CityNetwork cityNetwork;
+    cityNetwork.setUseSnapshots(false);
+    out << "Local Search (candidate lists of " << cityNetwork.getCandidateCount() << " nodes, built before timing):\n" << endl;
+    for (const char* str : extraGraphs) {
+        const string fullPath = projectPath + str;
+        if (!filesystem::exists(fullPath)) continue;
+        cityNetwork.initializeData(fullPath, false);
+        const pair<const char*, CityNetwork::Path> startTours[] = {
+            {"Nearest Neighbor", cityNetwork.nearestNeighbor()},
+            {"Greedy", cityNetwork.greedyAlgorithm()},
+        };
+        cityNetwork.twoOpt(startTours[0].second); // Builds the candidate lists.
+        out << str << '\n';
+        for (const auto& [startName, startPath] : startTours) {
+            if (!startPath.isValid()) continue;
+            out << startName << " tour: " << fixed << setprecision(2) << startPath.getDistance() << '\n';
+            for (const auto& config : configs) {
+                for (LocalSearch::Policy policy : {LocalSearch::firstImprovement, LocalSearch::bestImprovement}) {
+                    CityNetwork::Path path;
+                    auto start = chrono::high_resolution_clock::now();
+                    path = cityNetwork.localSearch(startPath, config.moves, policy);
+                    double ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+                    double gain = startPath.getDistance() - path.getDistance();
+                    string name = string(config.name) + (policy == LocalSearch::firstImprovement ? " (first)" : " (best)");
+                    out << "  " << name << string(max(1, 32 - (int) name.size()), ' ')
+                        << fixed << setprecision(2) << setw(12) << path.getDistance()
+                        << "  " << setw(7) << setprecision(2) << -100 * gain / startPath.getDistance() << "%"
+                        << "  " << setw(9) << setprecision(3) << ms << "ms"
+                        << "  " << setw(11) << setprecision(1) << gain / max(ms, 1e-3) << "/ms\n";
+                }
+            }
+        }
+        out << endl;
+    }
+}
+
+void Benchmark::exactScaling(ostream& out, const string& projectPath) {
+    const unsigned int threadCounts[] = {1, 2, 4, 8, 16};
+    const unsigned int subnetworkSizes[] = {12, 14, 16, 18, 20};
+    CityNetwork cityNetwork;
+    cityNetwork.setUseSnapshots(false);
+    out << "Branch and Bound Scaling (" << thread::hardware_concurrency() << " hardware threads):\n" << endl;
+    auto run = [&](CityNetwork& network, const string& name) {
+        out << name << " (" << network.getNodeCount() << " nodes)\n";
+        CityNetwork::Path serialPath;
+        double serialTime = 0;
+        for (unsigned int threads : threadCounts) {
+            network.setThreadCount(threads);
+            CityNetwork::Path path;
+            double time = bestOf(3, [&] { path = network.branchAndBound(); });
+            if (threads == 1) {
+                serialPath = path;
+                serialTime = time;
+            }
+            // The same tour, node by node, as on one thread.
+            const bool same = path.getDistance() == serialPath.getDistance() && path.getOrder() == serialPath.getOrder();
+            out << "  " << setw(2) << threads << " threads: " << fixed << setprecision(2) << setw(12) << path.getDistance()
+                << "  " << setw(10) << setprecision(3) << time * 1000 << "ms"
+                << "  " << setw(6) << setprecision(2) << serialTime / time << "x"
+                << (same ? "" : "  DIFFERENT TOUR") << '\n';
+        }
+        out << endl;
+    };
+    for (const char* str : {"graphs-toy/shipping.csv", "graphs-toy/stadiums.csv", "graphs-toy/tourism.csv"}) {
+        const string fullPath = projectPath + str;
+        if (!filesystem::exists(fullPath)) continue;
+        cityNetwork.initializeData(fullPath, false);
+        run(cityNetwork, str);
+    }
+    const string fullPath = projectPath + "graphs-extra/edges_25.csv";
+    if (!filesystem::exists(fullPath)) return;
+    cityNetwork.initializeData(fullPath, false);
+    for (unsigned int size : subnetworkSizes) {
+        CityNetwork network = cityNetwork.subnetwork(size);
+        run(network, "graphs-extra/edges_25.csv, first " + to_string(size) + " nodes");
+    }
+}
+
+void Benchmark::christofides(ostream& out, const string& projectPath) {
+    const int runs = 3;
+    const pair<const char*, function<CityNetwork::Path(CityNetwork&)>> algorithms[] = {
+        {"Triangular Approximation", [](CityNetwork& network) { return network.triangularApproximation(); }},
+        {"Christofides", [](CityNetwork& network) { return network.christofides(); }},
+        {"Christofides (greedy matching)", [](CityNetwork& network) { return network.christofides(CityNetwork::matchingGreedy); }},
+    };
+    CityNetwork cityNetwork;
+    cityNetwork.setUseSnapshots(false);
+    out << "Christofides vs Triangular Approximation (best of " << runs << " runs, exact matching up to "
+        << PerfectMatching::exactLimit << " odd nodes):\n" << endl;
+    vector<const char*> graphs(begin(extraGraphs), end(extraGraphs));
+    graphs.insert(graphs.end(), begin(realGraphs), end(realGraphs));
+    for (const char* str : graphs) {
+        const string fullPath = projectPath + str;
+        if (!filesystem::exists(fullPath)) continue;
+        cityNetwork.initializeData(fullPath, filesystem::is_directory(fullPath));
+        out << str << " (lower bound: " << fixed << setprecision(2) << cityNetwork.lowerBound() << ")\n";
+        double triangleDistance = NAN;
+        for (const auto& [name, algorithm] : algorithms) {
+            CityNetwork::Path path;
+            double time = bestOf(runs, [&] { path = algorithm(cityNetwork); });
+            if (isnan(triangleDistance)) triangleDistance = path.getDistance();
+            out << "  " << name << string(max(1, 32 - (int) strlen(name)), ' ');
+            if (!path.isValid()) {
+                out << "no path found\n";
+                continue;
+            }
+            const double gap = cityNetwork.optimalityGap(path);
+            out << fixed << setprecision(2) << setw(14) << path.getDistance() << "  ";
+            if (isfinite(triangleDistance)) out << setw(7) << 100 * (path.getDistance() / triangleDistance - 1) << "%";
+            else out << setw(8) << "n/a"; // The triangular approximation found no path.
+            out << " vs triangle"
+                << "  gap " << setw(6) << setprecision(2) << gap << "%"
+                << "  " << setw(10) << setprecision(3) << time * 1000 << "ms\n";
+        }
+        out << endl;
+    }
+}
+
+void Benchmark::generateNodes(const string& file, int count, unsigned int seed) {
+    const filesystem::path directory = filesystem::path(file).parent_path();
+    if (!directory.empty()) filesystem::create_directories(directory);
+    ofstream out(file);
+    if (!out) throw std::invalid_argument("Can't write " + file + "!");
+    mt19937_64 generator(seed);
+    // The first column is the longitude and the second the latitude, like in graphs-real.
+    const double minLon = -43.8, maxLon = -42.8, minLat = -23.05, maxLat = -22.55;
+    uniform_real_distribution<double> lonDistribution(minLon, maxLon), latDistribution(minLat, maxLat);
+    uniform_real_distribution<double> spreadDistribution(0.002, 0.03);
+    const int clusterCount = max(1, (int) sqrt((double) count) / 4);
+    vector<double> clusterLons(clusterCount), clusterLats(clusterCount), clusterSpreads(clusterCount);
+    for (int i = 0; i < clusterCount; i++) {
+        clusterLons[i] = lonDistribution(generator);
+        clusterLats[i] = latDistribution(generator);
+        clusterSpreads[i] = spreadDistribution(generator);
+    }
+    uniform_int_distribution<int> clusterDistribution(0, clusterCount - 1);
+    uniform_real_distribution<double> unit(0, 1);
+    normal_distribution<double> normal(0, 1);
+    out << "id,longitude,latitude\n" << fixed << setprecision(10);
+    for (int id = 0; id < count; id++) {
+        double lon, lat;
+        if (unit(generator) < 0.3) {
+            lon = lonDistribution(generator);
+            lat = latDistribution(generator);
+        } else {
+            const int cluster = clusterDistribution(generator);
+            lon = clamp(clusterLons[cluster] + normal(generator) * clusterSpreads[cluster], minLon, maxLon);
+            lat = clamp(clusterLats[cluster] + normal(generator) * clusterSpreads[cluster], minLat, maxLat);
+        }
+        out << id << ',' << lon << ',' << lat << '\n';
+    }
+}
+
+void Benchmark::spaceFillingCurve(ostream& out, const string& projectPath) {
+    const int sizes[] = {100000, 250000, 500000, 1000000};
+    CityNetwork cityNetwork;
+    cityNetwork.setUseSnapshots(false);
+    cityNetwork.setLazyEdges(true);
+    out << "Hilbert Curve Tours (edges computed on demand, " << cityNetwork.getThreadCount() << " threads):\n" << endl;
+    for (int size : sizes) {
+        const string directory = projectPath + "graphs-synthetic/nodes_" + to_string(size) + "/";
+        if (!filesystem::exists(directory + "nodes.csv")) generateNodes(directory + "nodes.csv", size);
+        auto start = chrono::high_resolution_clock::now();
+        cityNetwork.initializeData(directory, true);
+        const double loadTime = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+        out << "graphs-synthetic/nodes_" << size << "/ (load: " << fixed << setprecision(3) << loadTime << "s)\n";
+        auto report = [&](const string& name, const CityNetwork::Path& path, double time) {
+            out << "  " << name << string(max(1, 40 - (int) name.size()), ' ');
+            if (!path.isValid()) out << "no path found";
+            else out << fixed << setprecision(2) << setw(14) << path.getDistance();
+            out << "  " << setw(10) << setprecision(3) << time << "s\n";
+        };
+        CityNetwork::Path hilbertPath, path;
+        report("Hilbert Curve", hilbertPath, bestOf(1, [&] { hilbertPath = cityNetwork.hilbertCurve(); }));
+        report("Nearest Neighbor (Spatial Index)", path, bestOf(1, [&] { path = cityNetwork.spatialNearestNeighbor(); }));
+        // Includes building the candidate lists (from the spatial index).
+        report("2-opt + Or-opt from Hilbert Curve", path, bestOf(1, [&] {
+            path = cityNetwork.localSearch(hilbertPath, CityNetwork::moveTwoOpt | CityNetwork::moveOrOpt);
+        }));
+        out << endl;
+    }
+}
+
+void Benchmark::islands(ostream& out, const string& projectPath) {
+    const unsigned int islandCounts[] = {1, 2, 4, 8, 16};
+    const double seconds = 5;
+    CityNetwork cityNetwork;
+    cityNetwork.setUseSnapshots(false);
+    out << "Island Model Throughput (" << seconds << "s per run, " << thread::hardware_concurrency() << " hardware threads):\n" << endl;
+    for (const char* str : realGraphs) {
+        const string fullPath = projectPath + str;
+        if (!filesystem::exists(fullPath)) continue;
+        cityNetwork.initializeData(fullPath, true);
+        out << str << " (lower bound: " << fixed << setprecision(2) << cityNetwork.lowerBound() << ")\n";
+        double serialRate = 0;
+        for (unsigned int islandCount : islandCounts) {
+            IslandModel::Result result;
+            const CityNetwork::Path path = cityNetwork.islandSearch(seconds, islandCount, &result);
+            const double rate = (double) result.kicks / result.seconds;
+            if (islandCount == 1) serialRate = rate;
+            out << "  " << setw(2) << islandCount << " islands: " << setw(10) << setprecision(0) << rate << " tours/s"
+                << "  " << setw(6) << setprecision(2) << rate / serialRate << "x"
+                << "  " << setw(14) << setprecision(2) << path.getDistance()
+                << "  gap " << setw(5) << setprecision(2) << cityNetwork.optimalityGap(path) << "%"
+                << "  " << setw(4) << result.adoptions << " exchanges\n";
+        }
+        out << endl;
+    }
+}
+
+void Benchmark::solverService(ostream& out, const string& projectPath) {
+    const unsigned int threadCounts[] = {1, 2, 4, 8, 16};
+    const int requestCount = 500;
+    const SolverService::Algorithm algorithms[] = {
+        SolverService::algorithmNearestNeighbor, SolverService::algorithmGreedy, SolverService::algorithmChristofides,
+        SolverService::algorithmTwoOpt, SolverService::algorithmLinKernighan
+    };
+    out << "Solver Service Throughput (" << requestCount << " requests, " << thread::hardware_concurrency() << " hardware threads):\n" << endl;
+    for (const char* str : realGraphs) {
+        const string fullPath = projectPath + str;
+        if (!filesystem::exists(fullPath)) continue;
+        auto cityNetwork = make_shared<CityNetwork>();
+        cityNetwork->setUseSnapshots(false);
+        cityNetwork->initializeData(fullPath, true);
+        // The same requests for every thread count.
+        vector<int> ids;
+        for (int id = 0; id < (int) cityNetwork->getNodeCount(); id++)
+            if (cityNetwork->nodeExists(id)) ids.push_back(id);
+        mt19937 generator(1);
+        vector<SolverService::Request> requests(requestCount);
+        for (int i = 0; i < requestCount; i++) {
+            SolverService::Request& request = requests[i];
+            request.algorithm = algorithms[i % size(algorithms)];
+            shuffle(ids.begin(), ids.end(), generator);
+            request.nodeIds.assign(ids.begin(), ids.begin() + min(ids.size(), (size_t) uniform_int_distribution<int>(50, 200)(generator)));
+            request.startId = request.nodeIds[uniform_int_distribution<size_t>(0, request.nodeIds.size() - 1)(generator)];
+        }
+        out << str << " (" << cityNetwork->getNodeCount() << " nodes)\n";
+        {
+            // Untimed, so the first thread count doesn't pay for the first allocations.
+            SolverService service(cityNetwork, 1);
+            for (int i = 0; i < requestCount / 10; i++) (void) service.solve(requests[i]);
+        }
+        double serialRate = 0, serialTotal = 0;
+        for (unsigned int threads : threadCounts) {
+            SolverService service(cityNetwork, threads);
+            vector<future<CityNetwork::Path>> results;
+            double total = 0;
+            const auto start = chrono::high_resolution_clock::now();
+            for (const SolverService::Request& request : requests) results.push_back(service.submit(request));
+            for (future<CityNetwork::Path>& result : results) total += result.get().getDistance();
+            const double time = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+            const double rate = requestCount / time;
+            if (threads == 1) {
+                serialRate = rate;
+                serialTotal = total;
+            }
+            out << "  " << setw(2) << threads << " threads: " << fixed << setw(10) << setprecision(1) << rate << " requests/s"
+                << "  " << setw(6) << setprecision(2) << rate / serialRate << "x"
+                << (total == serialTotal ? "" : "  DIFFERENT TOURS") << '\n';
+        }
+        out << endl;
+    }
+}
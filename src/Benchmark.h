@@ -0,0 +1,90 @@
+#ifndef CITYNETWORK_BENCHMARK_H
+#define CITYNETWORK_BENCHMARK_H
+
+#include <ostream>
+#include <string>
+
+/**
+ * @brief The Benchmark namespace groups the performance comparisons that can be run from the data selection menu.
+ *
+ * Every benchmark writes a plain text report to the given stream. Dataset paths are relative to projectPath.
+ */
+namespace Benchmark {
+    /**
+     * @brief Compares the time taken by CSVReader::read (plus stoi/stod) and by the memory-mapped
+     * CSVReader::forEachLine (plus from_chars) to turn each graphs-extra file into typed edge records.
+     * @param out The stream the report is written to.
+     * @param projectPath The path to the project's directory.
+     */
+    void loading(std::ostream& out, const std::string& projectPath);
+
+    /**
+     * @brief Compares Node::operator- with the HaversineKernel (scalar and SIMD) computing every pairwise distance
+     * of the graphs-real node sets.
+     * @param out The stream the report is written to.
+     * @param projectPath The path to the project's directory.
+     */
+    void haversine(std::ostream& out, const std::string& projectPath);
+
+    /**
+     * @brief Runs the local search with different moves and policies on the nearest neighbor and greedy tours of the
+     * graphs-extra sets, reporting the tour-length gain per millisecond spent.
+     * @param out The stream the report is written to.
+     * @param projectPath The path to the project's directory.
+     */
+    void localSearch(std::ostream& out, const std::string& projectPath);
+
+    /**
+     * @brief Runs the branch and bound on 1, 2, 4, 8 and 16 threads on the toy graphs and on growing subnetworks of
+     * graphs-extra/edges_25.csv, reporting the speedup and checking that every run finds the same tour.
+     * @param out The stream the report is written to.
+     * @param projectPath The path to the project's directory.
+     */
+    void exactScaling(std::ostream& out, const std::string& projectPath);
+
+    /**
+     * @brief Compares Christofides' algorithm (with the default and the greedy matching) with the triangular
+     * approximation on the graphs-extra and graphs-real sets, reporting the time, the tour length and its gap to the
+     * lower bound.
+     * @param out The stream the report is written to.
+     * @param projectPath The path to the project's directory.
+     */
+    void christofides(std::ostream& out, const std::string& projectPath);
+
+    /**
+     * @brief Writes a synthetic nodes.csv (same format as graphs-real) with random coordinates: most nodes in
+     * clusters of different sizes around random centres, the rest spread uniformly, over an area like graphs-real/graph2.
+     * @param file The path of the file to write (its directory is created if needed).
+     * @param count The number of nodes.
+     * @param seed The seed of the random generator (the same seed gives the same file).
+     */
+    void generateNodes(const std::string& file, int count, unsigned int seed = 1);
+
+    /**
+     * @brief Times the Hilbert curve tour, the spatial nearest neighbor and the local search from the Hilbert curve
+     * tour on synthetic sets of 100k to 1M nodes (generated in graphs-synthetic if missing), with the edges computed
+     * on demand.
+     * @param out The stream the report is written to.
+     * @param projectPath The path to the project's directory.
+     */
+    void spaceFillingCurve(std::ostream& out, const std::string& projectPath);
+
+    /**
+     * @brief Runs the island model with 1, 2, 4, 8 and 16 islands (one per thread) on the graphs-real sets, reporting
+     * the tours evaluated per second, the speedup over one island and the best tour found.
+     * @param out The stream the report is written to.
+     * @param projectPath The path to the project's directory.
+     */
+    void islands(std::ostream& out, const std::string& projectPath);
+
+    /**
+     * @brief Answers the same mix of routing requests (random start nodes and subsets of 50 to 200 nodes, every
+     * SolverService algorithm) on the graphs-real sets with 1, 2, 4, 8 and 16 threads, reporting the requests
+     * answered per second and the speedup over one thread.
+     * @param out The stream the report is written to.
+     * @param projectPath The path to the project's directory.
+     */
+    void solverService(std::ostream& out, const std::string& projectPath);
+}
+
+#endif //CITYNETWORK_BENCHMARK_H
@@ -0,0 +1,76 @@
+#ifndef CITYNETWORK_BITSET_H
+#define CITYNETWORK_BITSET_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class Bitset
+ * @brief A resizable set of bits packed into 64-bit words.
+ *
+ * Used to store per-node and per-edge flags without paying a whole byte (or more) for each one.
+ */
+class Bitset {
+    std::vector<uint64_t> words; /**< The packed bits, 64 per word. */
+    size_t bitCount; /**< The number of bits in the set. */
+public:
+    /**
+     * @brief Constructs a bitset with the given number of bits, all cleared.
+     * @param size The number of bits.
+     */
+    explicit Bitset(size_t size = 0) : words((size + 63) / 64, 0), bitCount(size) {}
+    /**
+     * @brief Constructs a bitset from packed words, as given by getWords().
+     * @param size The number of bits.
+     * @param packed The (size + 63) / 64 words holding the bits.
+     */
+    Bitset(size_t size, const uint64_t* packed) : words(packed, packed + (size + 63) / 64), bitCount(size) {}
+    /**
+     * @brief Resizes the bitset, keeping the existing bits and clearing the new ones.
+     * @param size The new number of bits.
+     */
+    void resize(size_t size) {
+        words.resize((size + 63) / 64, 0);
+        if (size < bitCount && size % 64 != 0) words.back() &= (uint64_t(1) << (size % 64)) - 1;
+        bitCount = size;
+    }
+    /**
+     * @brief Clears every bit of the set.
+     */
+    void reset() { std::fill(words.begin(), words.end(), 0); }
+    /**
+     * @brief Gets the number of bits in the set.
+     * @return The number of bits.
+     */
+    [[nodiscard]] size_t size() const { return bitCount; }
+    /**
+     * @brief Checks the bit at the given position.
+     * @param pos The position of the bit.
+     * @return true if the bit is set, false otherwise.
+     */
+    [[nodiscard]] bool test(size_t pos) const { return (words[pos >> 6] >> (pos & 63)) & 1; }
+    /**
+     * @brief Sets the bit at the given position.
+     * @param pos The position of the bit.
+     */
+    void set(size_t pos) { words[pos >> 6] |= uint64_t(1) << (pos & 63); }
+    /**
+     * @brief Clears the bit at the given position.
+     * @param pos The position of the bit.
+     */
+    void clear(size_t pos) { words[pos >> 6] &= ~(uint64_t(1) << (pos & 63)); }
+    /**
+     * @brief Gets the packed words of the set, 64 bits each (the first bit is the lowest bit of the first word).
+     * @return The packed words.
+     */
+    [[nodiscard]] const std::vector<uint64_t>& getWords() const { return words; }
+    /**
+     * @brief Gets the memory used by the set, in bytes.
+     * @return The memory used.
+     */
+    [[nodiscard]] size_t memoryUsage() const { return words.capacity() * sizeof(uint64_t); }
+};
+
+#endif //CITYNETWORK_BITSET_H
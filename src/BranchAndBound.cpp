@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cmath>
+
+#include "BranchAndBound.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+BranchAndBound::BranchAndBound(const vector<double>& dist, int nodeCount) :
+    dist(dist), nodeCount(nodeCount), cheapest(nodeCount, INFINITY), cheapestTwo(nodeCount, INFINITY), tolerance(0),
+    sharedCost(INFINITY), bestCost(INFINITY), bestTask(0) {
+    for (int i = 0; i < nodeCount; i++) {
+        double first = INFINITY, second = INFINITY;
+        for (int j = 0; j < nodeCount; j++) {
+            if (i == j) continue;
+            const double d = dist[(size_t) i * nodeCount + j];
+            if (d < first) {
+                second = first;
+                first = d;
+            } else if (d < second) second = d;
+        }
+        if (nodeCount == 2) second = first; // The tour uses the only edge twice.
+        cheapest[i] = first;
+        cheapestTwo[i] = first + second;
+    }
+}
+
+void BranchAndBound::shareCost(double cost) {
+    double current = sharedCost.load();
+    while (cost < current && !sharedCost.compare_exchange_weak(current, cost)) {}
+}
+
+void BranchAndBound::search(Search& state, int current, int depth, double cost, double leftTwo) {
+    const double* row = &dist[(size_t) current * nodeCount];
+    if (depth == nodeCount) {
+        const double total = cost + row[0];
+        if (total < state.bestCost) {
+            state.bestCost = total;
+            state.bestOrder = state.order;
+            shareCost(total);
+        }
+        return;
+    }
+    for (int next = 1; next < nodeCount; next++) {
+        if (state.visited[next] || row[next] == INFINITY) continue;
+        const double newCost = cost + row[next];
+        const double newLeftTwo = leftTwo - cheapestTwo[next];
+        const double limit = sharedCost.load(memory_order_relaxed) + tolerance;
+        if (twoEdgeBound(next, newCost, newLeftTwo) > limit) continue;
+        state.visited[next] = true;
+        if (newCost + spanningTree(state, next) <= limit) {
+            state.order[depth] = next;
+            search(state, next, depth + 1, newCost, newLeftTwo);
+        }
+        state.visited[next] = false;
+    }
+}
+
+double BranchAndBound::spanningTree(Search& state, int from) const {
+    // Prim's algorithm on the dense matrix, keeping the nodes not in the tree first in left.
+    int leftCount = 0;
+    for (int nodeId = 0; nodeId < nodeCount; nodeId++) {
+        if (nodeId != 0 && state.visited[nodeId]) continue;
+        state.left[leftCount] = nodeId;
+        state.keys[leftCount++] = dist[(size_t) from * nodeCount + nodeId];
+    }
+    double total = 0;
+    while (leftCount > 0) {
+        int minIndex = 0;
+        for (int i = 1; i < leftCount; i++)
+            if (state.keys[i] < state.keys[minIndex]) minIndex = i;
+        if (state.keys[minIndex] == INFINITY) return INFINITY;
+        total += state.keys[minIndex];
+        const int nodeId = state.left[minIndex];
+        state.left[minIndex] = state.left[--leftCount];
+        state.keys[minIndex] = state.keys[leftCount];
+        const double* row = &dist[(size_t) nodeId * nodeCount];
+        for (int i = 0; i < leftCount; i++) state.keys[i] = min(state.keys[i], row[state.left[i]]);
+    }
+    return total;
+}
+
+vector<BranchAndBound::Subproblem> BranchAndBound::split(size_t count) const {
+    double leftTwo = 0;
+    for (int i = 1; i < nodeCount; i++) leftTwo += cheapestTwo[i];
+    vector<Subproblem> subproblems = {{{0}, 0, leftTwo}};
+    // Extends every path by one node at a time, in search order, cutting with the cheap bound.
+    for (int depth = 1; depth < nodeCount - 1 && subproblems.size() < count; depth++) {
+        vector<Subproblem> extended;
+        const double limit = sharedCost.load() + tolerance;
+        for (const Subproblem &subproblem : subproblems) {
+            const double* row = &dist[(size_t) subproblem.order.back() * nodeCount];
+            for (int next = 1; next < nodeCount; next++) {
+                if (row[next] == INFINITY) continue;
+                if (find(subproblem.order.begin(), subproblem.order.end(), next) != subproblem.order.end()) continue;
+                Subproblem child = {subproblem.order, subproblem.cost + row[next], subproblem.leftTwo - cheapestTwo[next]};
+                if (twoEdgeBound(next, child.cost, child.leftTwo) > limit) continue;
+                child.order.push_back(next);
+                extended.push_back(std::move(child));
+            }
+        }
+        subproblems = std::move(extended);
+    }
+    return subproblems;
+}
+
+void BranchAndBound::solveSubproblem(const Subproblem& subproblem, size_t index) {
+    Search state;
+    state.visited.assign(nodeCount, false);
+    state.order.assign(nodeCount, 0);
+    state.left.resize(nodeCount);
+    state.keys.resize(nodeCount);
+    state.bestCost = sharedCost.load() + tolerance; // A tour as long as the best one so far may still win the tie.
+    for (size_t i = 0; i < subproblem.order.size(); i++) {
+        state.visited[subproblem.order[i]] = true;
+        state.order[i] = subproblem.order[i];
+    }
+    search(state, subproblem.order.back(), (int) subproblem.order.size(), subproblem.cost, subproblem.leftTwo);
+    if (state.bestOrder.empty()) return;
+    // The shortest tour wins, the first subproblem on ties, like a single search would keep the first one it finds.
+    lock_guard<mutex> lock(bestMutex);
+    if (state.bestCost < bestCost || (state.bestCost == bestCost && index < bestTask)) {
+        bestCost = state.bestCost;
+        bestTask = index;
+        bestOrder = std::move(state.bestOrder);
+    }
+}
+
+vector<int> BranchAndBound::solve(double upperBound, unsigned int threadCount) {
+    if (nodeCount < 2) return {};
+    double leftTwo = 0;
+    for (int i = 1; i < nodeCount; i++) leftTwo += cheapestTwo[i];
+    if (leftTwo == INFINITY) return {}; // A node has less than two edges.
+    // Every tour is at least leftTwo / 2 long, so this slack is far above the rounding of the sums, and no tour that
+    // backtracking() could return is cut (or loses to the upper bound when it is as long).
+    tolerance = 1e-9 * leftTwo / 2;
+    sharedCost = upperBound;
+    bestOrder.clear();
+    bestCost = INFINITY;
+    bestTask = 0;
+    if (threadCount <= 1) {
+        solveSubproblem({{0}, 0, leftTwo}, 0);
+        return bestOrder;
+    }
+    const vector<Subproblem> subproblems = split(subproblemsPerThread * threadCount);
+    ThreadPool pool(threadCount);
+    for (size_t i = 0; i < subproblems.size(); i++)
+        pool.submit([this, &subproblems, i] { solveSubproblem(subproblems[i], i); });
+    pool.wait();
+    return bestOrder;
+}
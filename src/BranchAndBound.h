@@ -0,0 +1,111 @@
+#ifndef CITYNETWORK_BRANCHANDBOUND_H
+#define CITYNETWORK_BRANCHANDBOUND_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/**
+ * @class BranchAndBound
+ * @brief Exact shortest tours by depth-first branch and bound, optionally on several threads.
+ *
+ * The tours are built from node 0, trying the next nodes in increasing order, like CityNetwork::backtracking(). The
+ * path being built is kept in fixed arrays, and a branch is cut as soon as its lower bound exceeds the best tour
+ * found: the cost so far plus half of the two cheapest edges of every node left, of the cheapest edge of the current
+ * node and of the cheapest edge of node 0 (every node left still needs two edges, the ends one each). The sum of the
+ * two cheapest edges of the nodes left is updated as they are visited, so that bound takes O(1). The branches it
+ * keeps are then checked against the cost so far plus the minimum spanning tree of the current node, node 0 and the
+ * nodes left (the rest of the tour is a path through them), which takes O(V^2) but cuts far more.
+ *
+ * To run on several threads, the tree is split into the subtrees of the paths of a few nodes (the subproblems),
+ * which are searched on a work-stealing ThreadPool. The cost of the best tour found by any of them is shared through
+ * an atomic, so every subproblem cuts with it. Among the shortest tours, the one of the first subproblem (in search
+ * order) is kept, so the result is the same as on one thread.
+ */
+class BranchAndBound {
+    const std::vector<double>& dist; /**< The distance from node i to node j at i * nodeCount + j. */
+    int nodeCount; /**< The number of nodes. */
+    std::vector<double> cheapest; /**< The cheapest edge of every node. */
+    std::vector<double> cheapestTwo; /**< The sum of the two cheapest edges of every node. */
+    double tolerance; /**< The slack given to the bounds for the rounding of the sums. */
+    std::atomic<double> sharedCost; /**< The cost of the best tour found by any subproblem (or the upper bound). */
+    std::mutex bestMutex; /**< Guards bestOrder, bestCost and bestTask. */
+    std::vector<int> bestOrder; /**< The best tour found. */
+    double bestCost; /**< The cost of bestOrder. */
+    size_t bestTask; /**< The subproblem bestOrder comes from. */
+
+    /**
+     * @struct Search
+     * @brief The state of the search of one subproblem.
+     */
+    struct Search {
+        std::vector<char> visited; /**< Whether every node is on the current path. */
+        std::vector<int> order; /**< The current path, its first depth nodes. */
+        std::vector<int> left; /**< Scratch space of spanningTree(): the nodes not in the tree yet. */
+        std::vector<double> keys; /**< Scratch space of spanningTree(): the cheapest edge from the tree to each of them. */
+        std::vector<int> bestOrder; /**< The best tour of the subproblem. */
+        double bestCost; /**< The cost of bestOrder. */
+    };
+
+    /**
+     * @struct Subproblem
+     * @brief A path from node 0, whose completions are searched together.
+     */
+    struct Subproblem {
+        std::vector<int> order; /**< The nodes of the path. */
+        double cost; /**< The cost of the path. */
+        double leftTwo; /**< The sum of cheapestTwo of the nodes not on it. */
+    };
+
+    /**
+     * @brief Gets the lower bound of the paths that go on from a path (two cheapest edges).
+     */
+    [[nodiscard]] double twoEdgeBound(int current, double cost, double leftTwo) const {
+        return cost + (leftTwo + cheapest[current] + cheapest[0]) / 2;
+    }
+    /**
+     * @brief Lowers sharedCost to cost if it is lower.
+     */
+    void shareCost(double cost);
+    /**
+     * @brief Splits the tree into at least the given number of subproblems (fewer if the tree is too small), in
+     * search order.
+     */
+    std::vector<Subproblem> split(size_t count) const;
+    /**
+     * @brief Searches the completions of a subproblem and keeps its best tour if it is the best one.
+     */
+    void solveSubproblem(const Subproblem& subproblem, size_t index);
+    /**
+     * @brief Extends the path, which ends at current after depth nodes and costs cost, depth first.
+     * leftTwo is the sum of cheapestTwo of the nodes not visited.
+     */
+    void search(Search& state, int current, int depth, double cost, double leftTwo);
+    /**
+     * @brief Gets the cost of the minimum spanning tree of from, node 0 and the nodes not visited.
+     */
+    double spanningTree(Search& state, int from) const;
+
+public:
+    static constexpr size_t subproblemsPerThread = 16; /**< The number of subproblems made per thread. */
+
+    /**
+     * @brief Prepares the search.
+     * @param dist The distance from node i to node j at i * nodeCount + j (INFINITY if there is no edge).
+     * @param nodeCount The number of nodes.
+     */
+    BranchAndBound(const std::vector<double>& dist, int nodeCount);
+
+    /**
+     * @brief Finds the shortest tour that starts and ends at node 0.
+     *
+     * Among the shortest tours, it returns the first one in the order the nodes are tried, like backtracking() does,
+     * even if upperBound is the length of one of them, and whatever the number of threads.
+     * @param upperBound The length of a known tour (INFINITY if none), to cut branches from the start.
+     * @param threadCount The number of threads to use.
+     * @return The nodes in visiting order, starting at 0, or an empty vector if there is no tour.
+     */
+    std::vector<int> solve(double upperBound, unsigned int threadCount = 1);
+};
+
+#endif //CITYNETWORK_BRANCHANDBOUND_H
@@ -1,6 +1,8 @@
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <charconv>
+#include <stdexcept>
 
 #include "CSVReader.h"
 
@@ -19,3 +21,19 @@ CSV CSVReader::read(const std::string& file) {
     }
     return out;
 }
+
+int CSVReader::toInt(std::string_view field) {
+    int value = 0;
+    auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+    if (ec != std::errc() || ptr != field.data() + field.size() || field.empty())
+        throw std::invalid_argument("Invalid integer \"" + std::string(field) + "\"!");
+    return value;
+}
+
+double CSVReader::toDouble(std::string_view field) {
+    double value = 0;
+    auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+    if (ec != std::errc() || ptr != field.data() + field.size() || field.empty())
+        throw std::invalid_argument("Invalid number \"" + std::string(field) + "\"!");
+    return value;
+}
@@ -1,12 +1,15 @@
-
 #ifndef CITYNETWORK_CSVREADER_H
 #define CITYNETWORK_CSVREADER_H
 
+#include <cstring>
 #include <vector>
 #include <string>
+#include <string_view>
+#include "MappedFile.h"
 
 typedef std::vector<std::string> CSVLine;
 typedef std::vector<CSVLine> CSV;
+typedef std::vector<std::string_view> CSVFields;
 
 /**
  * @brief The CSVReader namespace groups functions related to reading CSV files.
@@ -22,6 +25,68 @@ namespace CSVReader {
      * @return CSV The parsed CSV data.
      */
     CSV read(const std::string& file);
+
+    /**
+     * @brief Splits the lines between begin and end into fields, calling f for every non-empty line.
+     *
+     * The fields are views into the given characters (no copies are made), with any trailing '\\r' and
+     * surrounding spaces removed. The same CSVFields object is reused for every line.
+     *
+     * @tparam Function The type of the callback, called as f(const CSVFields& fields).
+     * @param begin The first character to parse.
+     * @param end The character past the last one to parse.
+     * @param f The callback.
+     */
+    template <typename Function>
+    void forEachLine(const char* begin, const char* end, Function f) {
+        CSVFields fields;
+        while (begin < end) {
+            const char* lineEnd = static_cast<const char*>(memchr(begin, '\n', end - begin));
+            if (lineEnd == nullptr) lineEnd = end;
+            fields.clear();
+            const char* fieldBegin = begin;
+            while (true) {
+                const char* fieldEnd = static_cast<const char*>(memchr(fieldBegin, ',', lineEnd - fieldBegin));
+                if (fieldEnd == nullptr) fieldEnd = lineEnd;
+                const char* first = fieldBegin;
+                const char* last = fieldEnd;
+                while (first < last && (*first == ' ' || *first == '\t')) first++;
+                while (last > first && (last[-1] == '\r' || last[-1] == ' ' || last[-1] == '\t')) last--;
+                fields.emplace_back(first, last - first);
+                if (fieldEnd == lineEnd) break;
+                fieldBegin = fieldEnd + 1;
+            }
+            if (fields.size() > 1 || !fields[0].empty()) f(static_cast<const CSVFields&>(fields));
+            begin = lineEnd + 1;
+        }
+    }
+
+    /**
+     * @brief Splits every non-empty line of a mapped file into fields, calling f for each one.
+     * @tparam Function The type of the callback, called as f(const CSVFields& fields).
+     * @param file The mapped file.
+     * @param f The callback.
+     */
+    template <typename Function>
+    void forEachLine(const MappedFile& file, Function f) {
+        forEachLine(file.begin(), file.end(), f);
+    }
+
+    /**
+     * @brief Parses a whole field as an integer.
+     * @param field The field.
+     * @return The integer.
+     * @throws std::invalid_argument If the field isn't an integer.
+     */
+    int toInt(std::string_view field);
+
+    /**
+     * @brief Parses a whole field as a floating point number.
+     * @param field The field.
+     * @return The number.
+     * @throws std::invalid_argument If the field isn't a number.
+     */
+    double toDouble(std::string_view field);
 }
 
-#endif // CITYNETWORK_CSVREADER_H
\ No newline at end of file
+#endif // CITYNETWORK_CSVREADER_H
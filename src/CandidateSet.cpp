@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <cmath>
+
+#include "CandidateSet.h"
+
+using namespace std;
+
+void CandidateSet::reset(size_t size, int k) {
+    this->k = max(k, 0);
+    neighbours.assign(size * this->k, -1);
+    dists.assign(size * this->k, INFINITY);
+    counts.assign(size, 0);
+}
+
+void CandidateSet::clear() {
+    neighbours.clear();
+    dists.clear();
+    counts.clear();
+    k = 0;
+}
+
+void CandidateSet::assign(int nodeId, const vector<double>& row) {
+    vector<int> ids;
+    for (int destId = 0; destId < (int) row.size(); destId++)
+        if (destId != nodeId && row[destId] != INFINITY) ids.push_back(destId);
+    auto closer = [&row](int id1, int id2) {
+        return row[id1] < row[id2] || (row[id1] == row[id2] && id1 < id2);
+    };
+    const int count = min((int) ids.size(), k);
+    if (count < (int) ids.size()) nth_element(ids.begin(), ids.begin() + count, ids.end(), closer);
+    sort(ids.begin(), ids.begin() + count, closer);
+    for (int i = 0; i < count; i++) {
+        neighbours[(size_t) nodeId * k + i] = ids[i];
+        dists[(size_t) nodeId * k + i] = row[ids[i]];
+    }
+    counts[nodeId] = count;
+}
+
+void CandidateSet::assign(int nodeId, vector<pair<double, int>> nearest) {
+    sort(nearest.begin(), nearest.end());
+    const int count = min((int) nearest.size(), k);
+    for (int i = 0; i < count; i++) {
+        neighbours[(size_t) nodeId * k + i] = nearest[i].second;
+        dists[(size_t) nodeId * k + i] = nearest[i].first;
+    }
+    counts[nodeId] = count;
+}
+
+void CandidateSet::assignQuadrants(int nodeId, vector<pair<double, int>> nearest, const vector<double>& lats,
+                                   const vector<double>& lons) {
+    // The nearest k / 4 of every quadrant, each kept sorted by insertion (k is small).
+    const size_t perQuadrant = k / 4;
+    vector<pair<double, int>> quadrants[4];
+    for (const pair<double, int>& dest : nearest) {
+        vector<pair<double, int>>& best = quadrants[(lats[dest.second] >= lats[nodeId] ? 2 : 0) + (lons[dest.second] >= lons[nodeId] ? 1 : 0)];
+        if (best.size() == perQuadrant && (perQuadrant == 0 || !(dest < best.back()))) continue;
+        best.insert(upper_bound(best.begin(), best.end(), dest), dest);
+        if (best.size() > perQuadrant) best.pop_back();
+    }
+    vector<pair<double, int>> chosen;
+    for (const vector<pair<double, int>>& best : quadrants) chosen.insert(chosen.end(), best.begin(), best.end());
+    // The free slots go to the nearest destinations not chosen yet, which are among the k nearest.
+    const int count = min((int) nearest.size(), k);
+    if (count < (int) nearest.size()) nth_element(nearest.begin(), nearest.begin() + count, nearest.end());
+    sort(nearest.begin(), nearest.begin() + count);
+    for (int i = 0; i < count && (int) chosen.size() < k; i++)
+        if (find(chosen.begin(), chosen.end(), nearest[i]) == chosen.end()) chosen.push_back(nearest[i]);
+    assign(nodeId, std::move(chosen));
+}
+
+bool CandidateSet::contains(int nodeId, int candidateId) const {
+    const int* begin = getNeighbours(nodeId);
+    return find(begin, begin + counts[nodeId], candidateId) != begin + counts[nodeId];
+}
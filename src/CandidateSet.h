@@ -0,0 +1,95 @@
+#ifndef CITYNETWORK_CANDIDATESET_H
+#define CITYNETWORK_CANDIDATESET_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @class CandidateSet
+ * @brief The k nearest neighbours (candidates) of every node, ordered by distance.
+ *
+ * Good tours almost always connect a node to one of its few nearest neighbours, so heuristics that only look at the
+ * candidates consider kV edges instead of V^2. Candidates are ordered by distance, then by ID, and nodes with fewer
+ * than k valid edges have fewer candidates. The lists are stored in flat arrays, k slots per node. For the local
+ * searches on clustered coordinates, the lists can take the nearest nodes of every quadrant instead (see
+ * assignQuadrants()).
+ */
+class CandidateSet {
+    std::vector<int> neighbours; /**< The candidates of every node, k slots per node. */
+    std::vector<double> dists; /**< The distances to the candidates, parallel to neighbours. */
+    std::vector<int> counts; /**< The number of candidates of every node. */
+    int k = 0; /**< The maximum number of candidates per node. */
+public:
+    /**
+     * @brief Removes every list, leaving space for the given number of nodes.
+     * @param size The number of node IDs (the highest ID plus one).
+     * @param k The maximum number of candidates per node.
+     */
+    void reset(size_t size, int k);
+    /**
+     * @brief Removes every list.
+     */
+    void clear();
+    /**
+     * @brief Sets the candidates of a node to the nearest of the given destinations.
+     * @param nodeId The ID of the node.
+     * @param row The distance from the node to every node, indexed by ID (INFINITY if there is no edge).
+     */
+    void assign(int nodeId, const std::vector<double>& row);
+    /**
+     * @brief Sets the candidates of a node to the nearest of a few given destinations.
+     * @param nodeId The ID of the node.
+     * @param nearest The destinations, as (distance, ID) pairs, in any order.
+     */
+    void assign(int nodeId, std::vector<std::pair<double, int>> nearest);
+    /**
+     * @brief Sets the candidates of a node to the nearest destinations of each quadrant around it (k / 4 per quadrant),
+     * then to the nearest of the others, so that a node on the edge of a cluster also gets candidates across the gap.
+     *
+     * It takes O(n) time for n destinations.
+     * @param nodeId The ID of the node.
+     * @param nearest The destinations, as (distance, ID) pairs, in any order.
+     * @param lats The latitude of every node, by ID.
+     * @param lons The longitude of every node, by ID.
+     */
+    void assignQuadrants(int nodeId, std::vector<std::pair<double, int>> nearest, const std::vector<double>& lats,
+                         const std::vector<double>& lons);
+    /**
+     * @brief Gets the maximum number of candidates per node.
+     * @return k.
+     */
+    [[nodiscard]] int getK() const { return k; }
+    /**
+     * @brief Gets the number of nodes with candidate lists.
+     * @return The number of node IDs.
+     */
+    [[nodiscard]] size_t size() const { return counts.size(); }
+    /**
+     * @brief Gets the number of candidates of a node.
+     * @param nodeId The ID of the node.
+     * @return The number of candidates (at most k).
+     */
+    [[nodiscard]] int getCount(int nodeId) const { return counts[nodeId]; }
+    /**
+     * @brief Gets the candidates of a node.
+     * @param nodeId The ID of the node.
+     * @return The IDs of the getCount(nodeId) candidates, nearest first.
+     */
+    [[nodiscard]] const int* getNeighbours(int nodeId) const { return &neighbours[(size_t) nodeId * k]; }
+    /**
+     * @brief Gets the distances to the candidates of a node.
+     * @param nodeId The ID of the node.
+     * @return The distances, parallel to getNeighbours(nodeId).
+     */
+    [[nodiscard]] const double* getDists(int nodeId) const { return &dists[(size_t) nodeId * k]; }
+    /**
+     * @brief Checks if a node is a candidate of another.
+     * @param nodeId The ID of the node whose list is searched.
+     * @param candidateId The ID of the possible candidate.
+     * @return true if it is, false otherwise.
+     */
+    [[nodiscard]] bool contains(int nodeId, int candidateId) const;
+};
+
+#endif //CITYNETWORK_CANDIDATESET_H
@@ -3,99 +3,227 @@
 //
 
 #include "CityNetwork.h"
+#include "Snapshot.h"
+#include "GreedyMatching.h"
+#include "CandidateSet.h"
+#include "KdTree.h"
+#include "Tour.h"
+#include "LocalSearch.h"
+#include "LinKernighan.h"
+#include "HeldKarp.h"
+#include "BranchAndBound.h"
+#include "OneTreeBound.h"
+#include "PerfectMatching.h"
+#include "HilbertCurve.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <functional>
+#include <random>
 #include <stdexcept>
 #include <iostream>
 #include <iomanip>
 #include <queue>
 #include <stack>
+#include <cstring>
+#include <exception>
+#include <thread>
 
 using namespace std;
 
-CityNetwork::CityNetwork() : nodeCount(0), edgeCount(0), fakeEdgeCount(0) {}
+CityNetwork::CityNetwork() : lazyEdges(false), memoizeEdges(false), edgesOnDemand(false), nodeCount(0), edgeCount(0), fakeEdgeCount(0),
+    threadCount(max(thread::hardware_concurrency(), 1u)), useSnapshots(true), candidateCount(10), cachedLowerBound(NAN), cacheLocks(make_shared<CacheLocks>()) {}
 
-CityNetwork::CityNetwork(const string &datasetPath, bool isDirectory) : nodeCount(0), edgeCount(0), fakeEdgeCount(0) {
+CityNetwork::CityNetwork(const string &datasetPath, bool isDirectory) : CityNetwork() {
     initializeData(datasetPath, isDirectory);
 }
 
+void CityNetwork::setThreadCount(unsigned int count) {
+    threadCount = clamp(count, 1u, maxThreadCount);
+}
+
+void CityNetwork::setCandidateCount(int count) {
+    candidateCount = clamp(count, 1, maxCandidateCount);
+}
+
+void CityNetwork::setLazyEdges(bool lazy, bool memoize) {
+    lazyEdges = lazy;
+    memoizeEdges = memoize;
+}
+
 void CityNetwork::initializeData(const string &datasetPath, bool isDirectory) {
     clearData();
-    if (isDirectory) { // Expect edges.csv and nodes.csv
+    const vector<string> sources = isDirectory ? vector<string>{datasetPath + "nodes.csv", datasetPath + "edges.csv"} : vector<string>{datasetPath};
+    const string snapshotFile = Snapshot::getPath(datasetPath, isDirectory);
+    edgesOnDemand = isDirectory && lazyEdges; // Only coordinates can give the missing edges.
+    if (useSnapshots && !edgesOnDemand && Snapshot::load(*this, snapshotFile, sources)) return;
+    if (isDirectory) { // Expect nodes.csv, and edges.csv if some edges are given
         graphType = graphLatLon;
-        initializeNodes(CSVReader::read(datasetPath + "nodes.csv"));
-        initializeEdges(CSVReader::read(datasetPath + "edges.csv"));
+        initializeNodes(datasetPath + "nodes.csv");
+        initializeEdges(datasetPath + "edges.csv");
     } else {
-        CSV networkCSV = CSVReader::read(datasetPath);
-        graphType = (networkCSV[0].size() == 5) ? graphLabeled : graphNormal;
-        initializeNetwork(networkCSV);
+        initializeNetwork(datasetPath);
     }
     completeEdges();
+    if (useSnapshots && !edgesOnDemand) Snapshot::save(*this, snapshotFile, sources);
 }
 
 void CityNetwork::clearData() {
     nodes.clear();
+    distances.clear();
+    sparseEdges.clear();
+    distanceCache.clear();
+    distanceCache.shrink_to_fit();
+    haversine.clear();
+    candidates.clear();
+    searchCandidates.clear();
+    spatialIndex.clear();
+    cachedLowerBound = NAN;
+    workspaces.clear();
+    edgesOnDemand = false;
     nodeCount = 0;
     edgeCount = 0;
     fakeEdgeCount = 0;
 }
 
-void CityNetwork::initializeNetwork(const CSV &networkCSV) {
-    // From a single csv file.
-    int skipFirstLine = isalpha(networkCSV[0][0][0]) ? 1 : 0;
-    bool hasLabels = graphType == graphLabeled;
-    for (int i = skipFirstLine; i < networkCSV.size(); i++) {
-        const CSVLine &line = networkCSV[i];
-        if (line.size() != (hasLabels ? 5 : 3)) throw std::invalid_argument("File given isn't formatted correctly!");
-        int originId = stoi(line[0]);
-        int destId = stoi(line[1]);
-        if (!nodeExists(originId)) {
-            if (hasLabels) addNode(Node(originId, line[3]));
-            else addNode(Node(originId));
+CityNetwork::EdgeRecord CityNetwork::parseEdgeRecord(const CSVFields &line, size_t columns, const char *errorMessage) {
+    if (line.size() != columns) throw std::invalid_argument(errorMessage);
+    EdgeRecord record{CSVReader::toInt(line[0]), CSVReader::toInt(line[1]), CSVReader::toDouble(line[2]), {}, {}};
+    if (columns == 5) {
+        record.originLabel = line[3];
+        record.destLabel = line[4];
+    }
+    return record;
+}
+
+void CityNetwork::addEdgeRecord(const EdgeRecord &record, bool createNodes) {
+    if (createNodes) {
+        bool hasLabels = graphType == graphLabeled;
+        if (!nodeExists(record.origin)) {
+            if (hasLabels) addNode(Node(record.origin, string(record.originLabel)));
+            else addNode(Node(record.origin));
         }
-        if (!nodeExists(destId)) {
-            if (hasLabels) addNode(Node(destId, line[4]));
-            else addNode(Node(destId));
+        if (!nodeExists(record.dest)) {
+            if (hasLabels) addNode(Node(record.dest, string(record.destLabel)));
+            else addNode(Node(record.dest));
         }
     }
-    for (Node &node : nodes) { node.adj.resize(nodes.size()); }
-    for (int i = skipFirstLine; i < networkCSV.size(); i++) {
-        const CSVLine &line = networkCSV[i];
-        addEdge(Edge(stoi(line[0]), stoi(line[1]), stod(line[2])));
+    addEdge(Edge(record.origin, record.dest, record.dist));
+}
+
+void CityNetwork::readEdges(const char *begin, const char *end, size_t columns, bool createNodes, const char *errorMessage) {
+    const size_t minChunkSize = 1 << 16;
+    size_t chunkCount = min((size_t) threadCount, (size_t) (end - begin) / minChunkSize);
+    if (chunkCount <= 1) {
+        CSVReader::forEachLine(begin, end, [&](const CSVFields &line) {
+            addEdgeRecord(parseEdgeRecord(line, columns, errorMessage), createNodes);
+        });
+        return;
+    }
+    // Split into newline-aligned ranges.
+    vector<const char*> bounds = {begin};
+    for (size_t i = 1; i < chunkCount; i++) {
+        const char* pos = max(begin + (end - begin) * i / chunkCount, bounds.back());
+        const char* lineEnd = static_cast<const char*>(memchr(pos, '\n', end - pos));
+        bounds.push_back(lineEnd == nullptr ? end : lineEnd + 1);
+    }
+    bounds.push_back(end);
+    // Parse every range on its own thread.
+    vector<vector<EdgeRecord>> buffers(chunkCount);
+    vector<exception_ptr> errors(chunkCount);
+    vector<thread> threads;
+    for (size_t i = 0; i < chunkCount; i++) {
+        threads.emplace_back([&, i]() {
+            try {
+                buffers[i].reserve((bounds[i + 1] - bounds[i]) / 16);
+                CSVReader::forEachLine(bounds[i], bounds[i + 1], [&](const CSVFields &line) {
+                    buffers[i].push_back(parseEdgeRecord(line, columns, errorMessage));
+                });
+            } catch (...) {
+                errors[i] = current_exception();
+            }
+        });
+    }
+    for (thread &t : threads) t.join();
+    // Merge in file order, so the result is the same as a serial load.
+    for (size_t i = 0; i < chunkCount; i++) {
+        if (errors[i]) rethrow_exception(errors[i]);
+        for (const EdgeRecord &record : buffers[i]) addEdgeRecord(record, createNodes);
     }
 }
 
-void CityNetwork::initializeNodes(const CSV &nodesCSV) {
+void CityNetwork::initializeNetwork(const string &networkFile) {
+    // From a single csv file.
+    MappedFile file(networkFile);
+    const char* begin = file.begin();
+    const char* firstLineEnd = static_cast<const char*>(memchr(begin, '\n', file.getSize()));
+    if (firstLineEnd == nullptr) firstLineEnd = file.end();
+    size_t columns = 0;
+    bool hasHeader = false;
+    CSVReader::forEachLine(begin, firstLineEnd, [&](const CSVFields &line) {
+        columns = line.size();
+        hasHeader = !line[0].empty() && isalpha((unsigned char) line[0][0]);
+    });
+    if (columns == 0) throw std::invalid_argument("File given isn't formatted correctly!");
+    graphType = (columns == 5) ? graphLabeled : graphNormal;
+    if (hasHeader) begin = min(firstLineEnd + 1, file.end()); // Skip the header
+    readEdges(begin, file.end(), columns == 5 ? 5 : 3, true, "File given isn't formatted correctly!");
+    distances.resize(nodes.size());
+}
+
+void CityNetwork::initializeNodes(const string &nodesFile) {
     // From nodes.csv
-    size_t nodesSize = nodesCSV.size() - 1;
-    nodes.resize(nodesSize);
-    for (int i = 1; i < nodesCSV.size(); i++) { // Skip first line
-        const CSVLine &line = nodesCSV[i];
+    MappedFile file(nodesFile);
+    bool firstLine = true;
+    CSVReader::forEachLine(file, [&](const CSVFields &line) {
+        if (firstLine) { firstLine = false; return; } // Skip first line
         if (line.size() != 3) throw std::invalid_argument("nodes.csv isn't formatted correctly!");
-        Node n = Node(stoi(line[0]), stod(line[1]), stod(line[2]));
-        n.adj.resize(nodesSize);
-        addNode(n);
+        addNode(Node(CSVReader::toInt(line[0]), CSVReader::toDouble(line[1]), CSVReader::toDouble(line[2])));
+    });
+    if (!edgesOnDemand) distances.resize(nodes.size());
+    vector<double> lats(nodes.size()), lons(nodes.size());
+    for (const Node &node : nodes) {
+        if (node.id < 0) continue;
+        lats[node.id] = node.lat;
+        lons[node.id] = node.lon;
     }
+    haversine.assign(lats, lons);
 }
 
-void CityNetwork::initializeEdges(const CSV &edgesCSV) {
+void CityNetwork::initializeEdges(const string &edgesFile) {
     // From edges.csv
-    for (int i = 1; i < edgesCSV.size(); i++) { // Skip first line
-        const CSVLine &line = edgesCSV[i];
-        if (line.size() != 3) throw std::invalid_argument("edges.csv isn't formatted correctly!");
-        addEdge(Edge(stoi(line[0]), stoi(line[1]), stod(line[2])));
-    }
+    MappedFile file(edgesFile);
+    if (file.getSize() == 0) return; // No edges.csv (or an empty one): every edge comes from the coordinates.
+    const char* firstLineEnd = static_cast<const char*>(memchr(file.begin(), '\n', file.getSize()));
+    if (firstLineEnd == nullptr) return; // Nothing besides the header
+    readEdges(firstLineEnd + 1, file.end(), 3, false, "edges.csv isn't formatted correctly!");
 }
 
 void CityNetwork::completeEdges() {
-    for (Node &node : nodes) {
-        if (node.id < 0) continue;
-        for (int id = node.id + 1; id < nodes.size(); id++) {
-            if (getNode(id).id < 0) continue;
-            Edge &edge = node.adj[id];
-            if (edge.origin == -1 or edge.dest == -1) { // Non-existent Edge
+    if (edgesOnDemand) { // Only count the missing edges, they are computed when accessed.
+        unsigned long long pairs = (unsigned long long) nodeCount * (nodeCount - (nodeCount > 0)) / 2;
+        fakeEdgeCount = pairs - min(pairs, (unsigned long long) sparseEdges.size());
+        edgeCount += fakeEdgeCount;
+        if (memoizeEdges) {
+            size_t cacheSize = 1;
+            while (cacheSize < pairs && cacheSize < (1 << 20)) cacheSize <<= 1;
+            distanceCache.assign(cacheSize, CachedDistance());
+        }
+        return;
+    }
+    vector<double> row;
+    for (int id = 1; id < nodes.size(); id++) {
+        if (getNode(id).id < 0) continue;
+        if (graphType == graphLatLon) { // Distances to every node with a lower ID, in one batch.
+            row.resize(id);
+            haversine.distances(id, 0, id, row.data());
+        }
+        for (int otherId = 0; otherId < id; otherId++) {
+            if (getNode(otherId).id < 0) continue;
+            if (!distances.isValid(otherId, id)) { // Non-existent Edge
                 if (graphType == graphLatLon) {
-                    addEdge(Edge(node.id, id, node - getNode(id), false));
+                    addEdge(Edge(otherId, id, row[otherId], false));
                 } else {
-                    addEdge(Edge(node.id, id, INFINITY, false));
+                    addEdge(Edge(otherId, id, INFINITY, false));
                 }
                 fakeEdgeCount++;
             }
@@ -103,6 +231,25 @@ void CityNetwork::completeEdges() {
     }
 }
 
+void CityNetwork::getDistances(int nodeId, vector<double> &row) const {
+    row.resize(nodes.size());
+    if (!edgesOnDemand) {
+        int destId = 0;
+        for (const Edge &edge : getAdj(nodeId)) row[destId++] = edge.valid ? edge.dist : INFINITY;
+        return;
+    }
+    haversine.distances(nodeId, 0, (int) nodes.size(), row.data());
+    for (int destId = 0; destId < nodes.size(); destId++) {
+        if (destId == nodeId || nodes[destId].id < 0 || nodes[nodeId].id < 0) {
+            row[destId] = INFINITY;
+            continue;
+        }
+        if (sparseEdges.empty()) continue;
+        auto it = sparseEdges.find(DistanceMatrix::index(nodeId, destId));
+        if (it != sparseEdges.end()) row[destId] = it->second;
+    }
+}
+
 void CityNetwork::addNode(const Node &node) {
     if (nodes.size() <= node.id) nodes.resize(node.id + 1);
     nodeCount++;
@@ -113,117 +260,138 @@ void CityNetwork::addEdge(const CityNetwork::Edge &edge) {
     if (nodes.size() <= edge.origin) throw std::out_of_range("There isn't a node " + to_string(edge.origin) + "!");
     if (nodes.size() <= edge.dest) throw std::out_of_range("There isn't a node " + to_string(edge.dest) + "!");
     edgeCount++;
-    getNode(edge.origin).adj.at(edge.dest) = edge;
-    getNode(edge.dest).adj.at(edge.origin) = edge.reverse();
+    if (edge.origin == edge.dest) return;
+    if (edgesOnDemand) {
+        sparseEdges[DistanceMatrix::index(edge.origin, edge.dest)] = edge.dist;
+        return;
+    }
+    if (distances.size() < nodes.size()) distances.resize(nodes.size());
+    distances.set(edge.origin, edge.dest, edge.dist, edge.real);
 }
 
-vector<CityNetwork::Edge>& CityNetwork::getAdj(int nodeId) {
+CityNetwork::Adjacency CityNetwork::getAdj(int nodeId) const {
     if (nodes.size() <= nodeId) throw std::out_of_range("There isn't a node " + to_string(nodeId) + "!");
-    return getNode(nodeId).adj;
+    return {*this, nodeId};
 }
 
-bool CityNetwork::nodeExists(int nodeId) {
-    if (nodes.size() <= nodeId) return false;
-    return getNode(nodeId).id >= 0;
+bool CityNetwork::nodeExists(int nodeId) const {
+    if (nodeId < 0 || nodes.size() <= nodeId) return false;
+    return nodes[nodeId].id >= 0;
 }
 
 CityNetwork::Node& CityNetwork::getNode(int nodeId) {
     return nodes.at(nodeId);
 }
 
-CityNetwork::Edge& CityNetwork::getEdge(int nodeId1, int nodeId2) {
+CityNetwork::Edge CityNetwork::getEdge(int nodeId1, int nodeId2) const {
     if (nodes.size() <= nodeId1) throw std::out_of_range("There isn't a node " + to_string(nodeId1) + "!");
     if (nodes.size() <= nodeId2) throw std::out_of_range("There isn't a node " + to_string(nodeId2) + "!");
-    return getAdj(nodeId1).at(nodeId2);
-}
-
-void CityNetwork::clearVisits() {
-    for (Node& node : nodes) node.visited = false;
-}
-
-bool CityNetwork::isVisited(int nodeId) {
-    return getNode(nodeId).visited;
-}
-
-void CityNetwork::visit(int nodeId) {
-    getNode(nodeId).visited = true;
-}
-
-void CityNetwork::unvisit(int nodeId) {
-    getNode(nodeId).visited = false;
-}
-
-void CityNetwork::clearPrevs() {
-    for (Node& node : nodes) node.prev = -1;
+    if (nodeId1 == nodeId2) return {};
+    if (edgesOnDemand) {
+        auto it = sparseEdges.find(DistanceMatrix::index(nodeId1, nodeId2));
+        if (it != sparseEdges.end()) return {nodeId1, nodeId2, it->second};
+        if (nodes[nodeId1].id < 0 || nodes[nodeId2].id < 0) return {};
+        return {nodeId1, nodeId2, computeDistance(nodeId1, nodeId2), false};
+    }
+    if (!distances.isValid(nodeId1, nodeId2)) return {};
+    return {nodeId1, nodeId2, distances.getDist(nodeId1, nodeId2), distances.isReal(nodeId1, nodeId2)};
 }
 
-int CityNetwork::getPrev(int nodeId) {
-    return getNode(nodeId).prev;
+/**
+ * @brief Gets the bits of a double, to check the slots of the distance cache.
+ */
+static uint64_t doubleBits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
 }
 
-void CityNetwork::setPrev(int nodeId, int prev) {
-    getNode(nodeId).prev = prev;
-}
+CityNetwork::CachedDistance::CachedDistance() : check(SIZE_MAX ^ doubleBits(INFINITY)), dist(INFINITY) {}
 
-void CityNetwork::clearUses() {
-    for (Node &node : nodes) {
-        for (Edge &edge : node.adj) {
-            edge.used = false;
-        }
-    }
-}
+CityNetwork::CachedDistance::CachedDistance(const CachedDistance &other) :
+    check(other.check.load(memory_order_relaxed)), dist(other.dist.load(memory_order_relaxed)) {}
 
-bool CityNetwork::isUsed(int originId, int destId) {
-    return getEdge(originId, destId).used;
+CityNetwork::CachedDistance &CityNetwork::CachedDistance::operator=(const CachedDistance &other) {
+    check.store(other.check.load(memory_order_relaxed), memory_order_relaxed);
+    dist.store(other.dist.load(memory_order_relaxed), memory_order_relaxed);
+    return *this;
 }
 
-void CityNetwork::use(int originId, int destId) {
-    getEdge(originId, destId).used = true;
-    getEdge(destId, originId).used = true;
+double CityNetwork::computeDistance(int nodeId1, int nodeId2) const {
+    if (nodeId1 > nodeId2) swap(nodeId1, nodeId2); // Same operand order as completeEdges().
+    if (distanceCache.empty()) return haversine.distance(nodeId1, nodeId2);
+    size_t pairIndex = DistanceMatrix::index(nodeId1, nodeId2);
+    CachedDistance &slot = distanceCache[(pairIndex * 0x9E3779B97F4A7C15ull >> 20) & (distanceCache.size() - 1)];
+    double dist = slot.dist.load(memory_order_relaxed);
+    if ((slot.check.load(memory_order_relaxed) ^ doubleBits(dist)) == pairIndex) return dist;
+    dist = haversine.distance(nodeId1, nodeId2);
+    slot.dist.store(dist, memory_order_relaxed);
+    slot.check.store(pairIndex ^ doubleBits(dist), memory_order_relaxed);
+    return dist;
 }
 
-void CityNetwork::backtrackingHelper(int currentNodeId, Path currentPath, Path& bestPath) {
-    if (currentPath.getPathSize() == nodeCount - 1) {
+void CityNetwork::backtrackingHelper(int currentNodeId, vector<int>& order, double distance, Bitset& visited, Path& bestPath) const {
+    if (order.size() == nodeCount) {
         Edge edge = getEdge(currentNodeId, 0);
         if (!edge.valid || !edge.real) return;
-        currentPath.addToPath(edge);
-        if (currentPath < bestPath) bestPath = currentPath;
+        if (distance + edge.dist < bestPath.getDistance()) bestPath = makePath(order);
         return;
     }
     for (const Edge& edge : getAdj(currentNodeId)){
         if (!edge.valid) continue;
-        if (!isVisited(edge.dest) and edge.real) {
-            visit(edge.dest);
-            currentPath.addToPath(edge);
-            backtrackingHelper(edge.dest, currentPath, bestPath);
-            currentPath.removeLast();
-            unvisit(edge.dest);
+        if (!visited.test(edge.dest) and edge.real) {
+            visited.set(edge.dest);
+            order.push_back(edge.dest);
+            backtrackingHelper(edge.dest, order, distance + edge.dist, visited, bestPath);
+            order.pop_back();
+            visited.clear(edge.dest);
         }
     }
 }
 
-CityNetwork::Path CityNetwork::backtracking() {
-    clearVisits();
-    visit(0);
-    Path bestPath = Path({}, INFINITY);
-    backtrackingHelper(0, Path(), bestPath);
+CityNetwork::Path CityNetwork::branchAndBound() const {
+    if (nodes.empty() || nodes[0].id < 0) return Path(INFINITY);
+    // The heuristic tours give the first upper bound, if they use only real edges like the tours searched.
+    double upperBound = INFINITY;
+    for (const Path &seed : {nearestNeighbor(), greedyAlgorithm()}) {
+        if (!seed.isValid() || seed.getPathSize() != nodeCount) continue;
+        const vector<int> &order = seed.getOrder();
+        bool real = true;
+        for (size_t i = 0; i < order.size(); i++) real = real && getEdge(order[i], order[(i + 1) % order.size()]).real;
+        if (real) upperBound = min(upperBound, seed.getDistance());
+    }
+    vector<double> dist;
+    const vector<int> ids = getRealDistances(dist);
+    vector<int> order = BranchAndBound(dist, (int) ids.size()).solve(upperBound, threadCount);
+    if (order.empty()) return Path(INFINITY);
+    for (int &nodeId : order) nodeId = ids[nodeId];
+    return makePath(order);
+}
+
+CityNetwork::Path CityNetwork::backtracking() const {
+    WorkspaceArena::Lease workspace = workspaces.acquire(nodes.size());
+    workspace->visited.set(0);
+    Path bestPath = Path(INFINITY);
+    vector<int> order{0};
+    backtrackingHelper(0, order, 0, workspace->visited, bestPath);
     return bestPath;
 }
 
-vector<int> CityNetwork::calcMST(int rootId) {
-    clearPrevs();
-    clearVisits();
+vector<int> CityNetwork::calcMST(int rootId, Workspace &workspace) const {
+    if (fakeEdgeCount == 0) return calcDenseMST(rootId, workspace);
+    Bitset &visited = workspace.visited;
+    vector<int> &parents = workspace.parents;
     priority_queue<pair<double, pair<int, int>>, vector<pair<double, pair<int, int>>>, greater<>> pq;
     pq.emplace(0.0, pair<int,int>{rootId, -1});
     while (!pq.empty()) {
         auto [_, nodeIds] = pq.top(); pq.pop();
         auto [nodeId, prevId] = nodeIds;
-        if (isVisited(nodeId)) continue;
-        setPrev(nodeId, prevId);
-        visit(nodeId);
+        if (visited.test(nodeId)) continue;
+        parents[nodeId] = prevId;
+        visited.set(nodeId);
         for (const Edge& edge : getAdj(nodeId)) {
             if (!edge.valid) continue;
-            if (!isVisited(edge.dest) and edge.real) {
+            if (!visited.test(edge.dest) and edge.real) {
                 pq.emplace(edge.dist, pair<int,int>{edge.dest, nodeId});
             }
         }
@@ -235,11 +403,10 @@ vector<int> CityNetwork::calcMST(int rootId) {
         int nodeId = toTraverse.top();
         toTraverse.pop();
         mstPath.push_back(nodeId);
-        const Node& node = getNode(nodeId);
-        for (auto it = node.adj.rbegin(); it != node.adj.rend(); it++) {
-            const Edge& edge = *it;
+        for (int destId = (int) nodes.size() - 1; destId >= 0; destId--) {
+            const Edge edge = getEdge(nodeId, destId);
             if (!edge.valid) continue;
-            if (getPrev(edge.dest) == nodeId) {
+            if (parents[edge.dest] == nodeId) {
                 toTraverse.push(edge.dest);
             }
         }
@@ -247,102 +414,584 @@ vector<int> CityNetwork::calcMST(int rootId) {
     return mstPath;
 }
 
-CityNetwork::Path CityNetwork::triangularApproximation() {
-    vector<int> mstPath = calcMST(0);
-    Path path;
-    for (int i = 0; i < mstPath.size(); i++)
-        path.addToPath(getEdge(mstPath[i], mstPath[(i + 1) % mstPath.size()]));
-    return path;
+vector<int> CityNetwork::calcDenseMST(int rootId, Workspace &workspace) const {
+    const int size = (int) nodes.size();
+    vector<double> &keys = workspace.keys, &row = workspace.row;
+    vector<int> &parents = workspace.parents;
+    Bitset &inTree = workspace.visited;
+    keys.assign(size, INFINITY);
+    for (int id = 0; id < size; id++)
+        if (nodes[id].id < 0) inTree.set(id); // Missing IDs are never added.
+    keys[rootId] = 0;
+    for (int nodeId = rootId; nodeId >= 0;) {
+        inTree.set(nodeId);
+        getDistances(nodeId, row);
+        // Update the keys and find the next node in the same pass. Ties go to the lowest node and parent IDs, like
+        // the priority queue of calcMST() orders them.
+        int nextId = -1;
+        for (int destId = 0; destId < size; destId++) {
+            if (inTree.test(destId)) continue;
+            if (row[destId] < keys[destId] || (row[destId] == keys[destId] && nodeId < parents[destId])) {
+                keys[destId] = row[destId];
+                parents[destId] = nodeId;
+            }
+            if (nextId < 0 || keys[destId] < keys[nextId]) nextId = destId;
+        }
+        if (nextId >= 0 && keys[nextId] == INFINITY) break; // The rest isn't connected.
+        nodeId = nextId;
+    }
+    // The children of every node, in increasing ID order, then the pre-order walk.
+    vector<vector<int>> children(size);
+    for (int id = 0; id < size; id++) {
+        if (parents[id] < 0) continue;
+        if (inTree.test(id) && nodes[id].id >= 0) children[parents[id]].push_back(id);
+        else parents[id] = -1; // Not reached.
+    }
+    vector<int> mstPath;
+    stack<int> toTraverse;
+    toTraverse.push(rootId);
+    while (!toTraverse.empty()) {
+        int nodeId = toTraverse.top();
+        toTraverse.pop();
+        mstPath.push_back(nodeId);
+        for (auto it = children[nodeId].rbegin(); it != children[nodeId].rend(); it++) toTraverse.push(*it);
+    }
+    return mstPath;
 }
 
-CityNetwork::Path CityNetwork::nearestNeighbor() {
-    clearVisits();
-    Path path;
-    int currNodeId = 0;
-    visit(currNodeId);
-    while (path.getPathSize() < nodeCount - 1) {
-        Edge minEdge;
-        for (Edge &edge: getAdj(currNodeId)) {
-            if (!edge.valid) continue;
-            if (!isVisited(edge.dest) && edge.dist < minEdge.dist) minEdge = edge;
+CityNetwork::Path CityNetwork::triangularApproximation() const {
+    WorkspaceArena::Lease workspace = workspaces.acquire(nodes.size());
+    return makePath(calcMST(0, *workspace));
+}
+
+CityNetwork::Path CityNetwork::christofides(MatchingMethod method) const {
+    if (nodes.empty() || nodes[0].id < 0) return Path(INFINITY);
+    // Over all the edges, so coordinate datasets use the great-circle distances of their missing edges.
+    WorkspaceArena::Lease workspace = workspaces.acquire(nodes.size());
+    const vector<int> mstPath = calcDenseMST(0, *workspace);
+    const vector<int> &parents = workspace->parents;
+    if (mstPath.size() != nodeCount) return Path(INFINITY);
+    // The tree and matching edges form a multigraph, kept as edge lists with the edges at each node.
+    vector<pair<int, int>> multiEdges;
+    vector<vector<int>> incident(nodes.size());
+    auto addMultiEdge = [&](int nodeId1, int nodeId2) {
+        incident[nodeId1].push_back((int) multiEdges.size());
+        incident[nodeId2].push_back((int) multiEdges.size());
+        multiEdges.emplace_back(nodeId1, nodeId2);
+    };
+    for (int nodeId : mstPath)
+        if (parents[nodeId] >= 0) addMultiEdge(parents[nodeId], nodeId);
+
+    vector<int> odd;
+    for (int nodeId : mstPath)
+        if (incident[nodeId].size() % 2) odd.push_back(nodeId);
+    if (!odd.empty()) {
+        const int size = (int) odd.size();
+        vector<double> dist((size_t) size * size);
+        vector<double> &row = workspace->row;
+        for (int i = 0; i < size; i++) {
+            getDistances(odd[i], row);
+            for (int j = 0; j < size; j++) dist[(size_t) i * size + j] = row[odd[j]];
         }
-        if (!minEdge.valid) return Path({}, INFINITY);
-        path.addToPath(minEdge);
-        currNodeId = minEdge.dest;
-        visit(currNodeId);
+        const bool exact = method == matchingExact || (method == matchingAuto && size <= PerfectMatching::exactLimit);
+        const vector<int> mates = exact ? PerfectMatching::exact(dist, size) : PerfectMatching::greedy(dist, size);
+        if (mates.empty()) return Path(INFINITY);
+        for (int i = 0; i < size; i++)
+            if (i < mates[i]) addMultiEdge(odd[i], odd[mates[i]]);
     }
-    path.addToPath(getEdge(currNodeId, 0));
-    return path;
+
+    // Hierholzer's algorithm from node 0. The circuit comes out backwards, ending at node 0.
+    vector<char> used(multiEdges.size(), false);
+    vector<size_t> nextEdge(nodes.size(), 0);
+    vector<int> circuit, walk{0};
+    while (!walk.empty()) {
+        const int nodeId = walk.back();
+        size_t& edgeIndex = nextEdge[nodeId];
+        while (edgeIndex < incident[nodeId].size() && used[incident[nodeId][edgeIndex]]) edgeIndex++;
+        if (edgeIndex == incident[nodeId].size()) {
+            circuit.push_back(nodeId);
+            walk.pop_back();
+            continue;
+        }
+        const int edge = incident[nodeId][edgeIndex];
+        used[edge] = true;
+        walk.push_back(multiEdges[edge].first == nodeId ? multiEdges[edge].second : multiEdges[edge].first);
+    }
+    // Skip the nodes already visited.
+    vector<char> inTour(nodes.size(), false);
+    vector<int> order;
+    for (auto it = circuit.rbegin(); it != circuit.rend(); it++) {
+        if (inTour[*it]) continue;
+        inTour[*it] = true;
+        order.push_back(*it);
+    }
+    return makePath(order);
 }
 
-class GreaterEdge {
-public:
-    bool operator()(const CityNetwork::Edge& edge1, const CityNetwork::Edge& edge2) {
-        return edge2 < edge1;
+vector<int> CityNetwork::nearestNeighborOrder(int startId, Workspace &workspace) const {
+    Bitset &visited = workspace.visited;
+    vector<double> &row = workspace.row;
+    visited.resize(nodes.size());
+    visited.reset();
+    vector<int> order{startId};
+    visited.set(startId);
+    int currNodeId = startId;
+    while (order.size() < nodeCount) {
+        getDistances(currNodeId, row);
+        int minId = -1;
+        double minDist = INFINITY;
+        for (int destId = 0; destId < nodes.size(); destId++) {
+            if (!visited.test(destId) && row[destId] < minDist) {
+                minDist = row[destId];
+                minId = destId;
+            }
+        }
+        if (minId < 0) return {};
+        order.push_back(minId);
+        currNodeId = minId;
+        visited.set(currNodeId);
     }
-};
+    return order;
+}
 
-CityNetwork::Path CityNetwork::greedyAlgorithm() {
-    clearUses();
-    clearVisits();
-    // The amount of edges attached to a node.
-    vector<pair<int,int>> nodeEdges = vector(nodes.size(), pair<int,int>{0, -1});
-    int nodesFinished = 0;
-    priority_queue<Edge, vector<Edge>, GreaterEdge> pq;
-    for (Node &node : nodes) {
-        if (node.id < 0) continue;
-        for (int nodeId = node.id + 1; nodeId < nodes.size(); nodeId++) {
-            if (getNode(nodeId).id < 0) continue;
-            Edge edge = getEdge(node.id, nodeId);
-            if (edge.valid) pq.push(edge);
+CityNetwork::Path CityNetwork::nearestNeighbor(int startId) const {
+    if (!nodeExists(startId)) return Path(INFINITY);
+    WorkspaceArena::Lease workspace = workspaces.acquire(nodes.size());
+    const vector<int> order = nearestNeighborOrder(startId, *workspace);
+    if (order.empty()) return Path(INFINITY);
+    return makePath(order);
+}
+
+CityNetwork::Path CityNetwork::multiStartNearestNeighbor(unsigned int startCount) const {
+    if (nodes.empty() || nodes[0].id < 0) return Path(INFINITY);
+    vector<int> ids;
+    for (const Node &node : nodes)
+        if (node.id >= 0) ids.push_back(node.id);
+    // Evenly spaced start nodes (all of them if startCount is 0 or too large), node 0 always among them.
+    vector<int> starts;
+    if (startCount == 0 || startCount >= ids.size()) starts = ids;
+    else for (unsigned int i = 0; i < startCount; i++) starts.push_back(ids[(size_t) i * ids.size() / startCount]);
+    vector<double> lengths(starts.size(), INFINITY);
+    ThreadPool pool(threadCount);
+    for (size_t i = 0; i < starts.size(); i++) {
+        pool.submit([this, &starts, &lengths, i] {
+            WorkspaceArena::Lease workspace = workspaces.acquire(nodes.size());
+            const vector<int> order = nearestNeighborOrder(starts[i], *workspace);
+            if (order.empty()) return;
+            double length = getEdge(order.back(), order.front()).dist;
+            for (size_t j = 1; j < order.size(); j++) length += getEdge(order[j - 1], order[j]).dist;
+            lengths[i] = length;
+        });
+    }
+    pool.wait();
+    // The shortest tour, the first start on ties, so the result doesn't depend on the threads.
+    const size_t best = min_element(lengths.begin(), lengths.end()) - lengths.begin();
+    if (lengths[best] == INFINITY) return Path(INFINITY);
+    WorkspaceArena::Lease workspace = workspaces.acquire(nodes.size());
+    vector<int> order = nearestNeighborOrder(starts[best], *workspace);
+    rotate(order.begin(), find(order.begin(), order.end(), 0), order.end());
+    return makePath(order);
+}
+
+CityNetwork::Path CityNetwork::greedyAlgorithm() const {
+    // On demand, the pool of every pair would take O(V^2) memory: only the candidate edges are matched instead.
+    if (edgesOnDemand) return candidateGreedyAlgorithm();
+    // Every valid edge between existing nodes, in the order of the distance matrix (ties are then kept in that order).
+    vector<GreedyMatching::CandidateEdge> edges;
+    edges.reserve((size_t) nodeCount * (nodeCount - (nodeCount > 0)) / 2);
+    vector<double> row;
+    for (int id = 0; id < (int) nodes.size(); id++) {
+        if (nodes[id].id < 0) continue;
+        getDistances(id, row);
+        for (int otherId = 0; otherId < id; otherId++) {
+            if (nodes[otherId].id < 0 || row[otherId] == INFINITY) continue;
+            edges.push_back({row[otherId], otherId, id});
         }
     }
-    while (nodesFinished != nodeCount) { // Last 2 nodes to connect.
-        Edge edge = pq.top(); pq.pop();
-        if (nodeEdges[edge.origin].first == 2) continue;
-        if (nodeEdges[edge.dest].first == 2) continue;
-        if (nodeEdges[edge.origin].first == 1 && nodeEdges[edge.dest].first == 1) {
-            // Verify if it doesn't finish the cycle too early
-            if (nodesFinished != nodeCount - 2 && nodeEdges[edge.origin].second == nodeEdges[edge.dest].second) continue; // Cycle
-            int prevId = nodeEdges[edge.dest].second;
-            for (auto &[count, cycleId]: nodeEdges) {
-                if (cycleId == prevId) {
-                    cycleId = nodeEdges[edge.origin].second; // Update to the new cycle id
-                }
+    GreedyMatching::sortEdges(edges, edges.size() >= radixSortThreshold);
+    GreedyMatching matching(nodes.size(), nodeCount);
+    matching.addEdges(edges);
+    if (!matching.isComplete()) return Path(INFINITY);
+    return makePath(matching.getTour(0));
+}
+
+const CandidateSet &CityNetwork::getCandidates() const {
+    lock_guard<mutex> lock(cacheLocks->candidates);
+    if (candidates.getK() == candidateCount && candidates.size() == nodes.size()) return candidates;
+    buildCandidates(candidates, false);
+    return candidates;
+}
+
+const CandidateSet &CityNetwork::getSearchCandidates() const {
+    if (graphType != graphLatLon) return getCandidates(); // Only coordinates have quadrants.
+    lock_guard<mutex> lock(cacheLocks->searchCandidates);
+    if (searchCandidates.getK() == candidateCount && searchCandidates.size() == nodes.size()) return searchCandidates;
+    buildCandidates(searchCandidates, true);
+    return searchCandidates;
+}
+
+void CityNetwork::buildCandidates(CandidateSet &set, bool quadrants) const {
+    // When every distance is a great-circle one computed on demand, the nearest nodes come from the k-d tree instead of
+    // full rows, so huge datasets never take O(V^2) time.
+    const bool spatial = edgesOnDemand && sparseEdges.empty();
+    const KdTree *index = spatial ? &getSpatialIndex() : nullptr;
+    vector<double> lats, lons;
+    if (quadrants) getCoordinates(lats, lons);
+    set.reset(nodes.size(), candidateCount);
+    // Every row is independent, so the nodes are split among the threads.
+    auto buildRange = [this, index, quadrants, &set, &lats, &lons](int begin, int end) {
+        vector<double> row;
+        vector<pair<double, int>> nearest;
+        for (int id = begin; id < end; id++) {
+            if (nodes[id].id < 0) continue;
+            if (index != nullptr) {
+                nearest.clear();
+                for (int destId : index->nearest(id, quadrants ? quadrantPool * candidateCount : candidateCount))
+                    nearest.emplace_back(haversine.distance(min(id, destId), max(id, destId)), destId);
+                if (quadrants) set.assignQuadrants(id, nearest, lats, lons);
+                else set.assign(id, nearest);
+                continue;
+            }
+            getDistances(id, row);
+            if (!quadrants) {
+                set.assign(id, row);
+                continue;
             }
-            nodesFinished += 2;
-        } else if (nodeEdges[edge.origin].first == 1) {
-            nodeEdges[edge.dest].second = nodeEdges[edge.origin].second;
-            nodesFinished++;
-        } else if (nodeEdges[edge.dest].first == 1) {
-            nodeEdges[edge.origin].second = nodeEdges[edge.dest].second;
-            nodesFinished++;
-        } else {
-            nodeEdges[edge.origin].second = edge.origin;
-            nodeEdges[edge.dest].second = edge.origin;
+            nearest.clear();
+            for (int destId = 0; destId < (int) row.size(); destId++)
+                if (destId != id && row[destId] != INFINITY) nearest.emplace_back(row[destId], destId);
+            set.assignQuadrants(id, nearest, lats, lons);
         }
-        use(edge.origin, edge.dest);
-        nodeEdges[edge.origin].first++;
-        nodeEdges[edge.dest].first++;
-    }
-    Path path;
-    int currId = 0;
-    visit(currId);
-    while (path.getPathSize() < nodeCount - 1) {
-        for (Edge &edge : getAdj(currId)) {
-            if (!edge.valid) continue;
-            if (!isVisited(edge.dest) && isUsed(currId, edge.dest)) {
-                path.addToPath(edge);
-                currId = edge.dest;
-                visit(currId);
+    };
+    const int size = (int) nodes.size();
+    const int chunkCount = (int) min((size_t) threadCount, nodes.size() / 256 + 1);
+    vector<thread> threads;
+    for (int i = 1; i < chunkCount; i++)
+        threads.emplace_back(buildRange, (int) ((long long) size * i / chunkCount), (int) ((long long) size * (i + 1) / chunkCount));
+    buildRange(0, size / chunkCount);
+    for (thread &t : threads) t.join();
+}
+
+CityNetwork::Path CityNetwork::candidateNearestNeighbor() const {
+    const CandidateSet &candidateSet = getCandidates();
+    WorkspaceArena::Lease workspace = workspaces.acquire(nodes.size());
+    Bitset &visited = workspace->visited;
+    vector<double> &row = workspace->row;
+    vector<int> order{0};
+    int currNodeId = 0;
+    visited.set(currNodeId);
+    while (order.size() < nodeCount) {
+        // The candidates are the nearest nodes, so the first unvisited one is the nearest unvisited node.
+        int minId = -1;
+        const int *neighbours = candidateSet.getNeighbours(currNodeId);
+        for (int i = 0; i < candidateSet.getCount(currNodeId); i++) {
+            if (!visited.test(neighbours[i])) {
+                minId = neighbours[i];
                 break;
             }
         }
+        if (minId < 0) { // Every candidate was visited: full scan.
+            getDistances(currNodeId, row);
+            double minDist = INFINITY;
+            for (int destId = 0; destId < nodes.size(); destId++) {
+                if (!visited.test(destId) && row[destId] < minDist) {
+                    minDist = row[destId];
+                    minId = destId;
+                }
+            }
+        }
+        if (minId < 0) return Path(INFINITY);
+        order.push_back(minId);
+        currNodeId = minId;
+        visited.set(currNodeId);
+    }
+    return makePath(std::move(order));
+}
+
+const KdTree &CityNetwork::getSpatialIndex() const {
+    lock_guard<mutex> lock(cacheLocks->spatialIndex);
+    if (spatialIndex.size() == 0) {
+        vector<double> lats, lons;
+        getCoordinates(lats, lons);
+        spatialIndex.assign(lats, lons);
+    }
+    return spatialIndex;
+}
+
+void CityNetwork::getCoordinates(vector<double> &lats, vector<double> &lons) const {
+    lats.assign(nodes.size(), INFINITY);
+    lons.assign(nodes.size(), INFINITY);
+    for (const Node &node : nodes) {
+        if (node.id < 0) continue;
+        lats[node.id] = node.lat;
+        lons[node.id] = node.lon;
+    }
+}
+
+CityNetwork::Path CityNetwork::hilbertCurve() const {
+    if (graphType != graphLatLon) return nearestNeighbor();
+    vector<double> lats, lons;
+    getCoordinates(lats, lons);
+    vector<int> order = HilbertCurve::sort(lats, lons);
+    if (order.size() != nodeCount || nodes.empty() || nodes[0].id < 0) return Path(INFINITY);
+    rotate(order.begin(), find(order.begin(), order.end(), 0), order.end());
+    return makePath(order);
+}
+
+CityNetwork::Path CityNetwork::spatialNearestNeighbor() const {
+    if (graphType != graphLatLon) return nearestNeighbor();
+    const KdTree &index = getSpatialIndex();
+    WorkspaceArena::Lease workspace = workspaces.acquire(nodes.size());
+    KdTree::Removals &removals = workspace->removals;
+    index.restore(removals);
+    vector<int> order{0};
+    int currNodeId = 0;
+    index.remove(currNodeId, removals);
+    while (order.size() < nodeCount) {
+        int nextId = index.nearest(currNodeId, removals);
+        if (nextId < 0) return Path(INFINITY);
+        order.push_back(nextId);
+        currNodeId = nextId;
+        index.remove(currNodeId, removals);
+    }
+    return makePath(std::move(order));
+}
+
+CityNetwork::Path CityNetwork::candidateGreedyAlgorithm() const {
+    const CandidateSet &candidateSet = getCandidates();
+    // Every candidate edge once, with the lower ID first, in the order of the distance matrix.
+    vector<GreedyMatching::CandidateEdge> edges;
+    for (int id = 0; id < (int) candidateSet.size(); id++) {
+        const int *neighbours = candidateSet.getNeighbours(id);
+        const double *dists = candidateSet.getDists(id);
+        for (int i = 0; i < candidateSet.getCount(id); i++) {
+            if (neighbours[i] < id && candidateSet.contains(neighbours[i], id)) continue; // Added from the other side.
+            edges.push_back({dists[i], min(id, neighbours[i]), max(id, neighbours[i])});
+        }
+    }
+    sort(edges.begin(), edges.end(), [](const GreedyMatching::CandidateEdge &edge1, const GreedyMatching::CandidateEdge &edge2) {
+        return edge1.dest < edge2.dest || (edge1.dest == edge2.dest && edge1.origin < edge2.origin);
+    });
+    GreedyMatching::sortEdges(edges, edges.size() >= radixSortThreshold);
+    GreedyMatching matching(nodes.size(), nodeCount);
+    matching.addEdges(edges);
+    if (!matching.isComplete()) {
+        // Candidates ran out: only the ends of the fragments can still take edges, so join them with a full scan.
+        vector<int> ends;
+        for (int id = 0; id < (int) nodes.size(); id++)
+            if (nodes[id].id >= 0 && matching.getDegree(id) < 2) ends.push_back(id);
+        edges.clear();
+        vector<double> row;
+        for (size_t i = 1; i < ends.size(); i++) {
+            getDistances(ends[i], row);
+            for (size_t j = 0; j < i; j++)
+                if (row[ends[j]] != INFINITY) edges.push_back({row[ends[j]], ends[j], ends[i]});
+        }
+        GreedyMatching::sortEdges(edges, edges.size() >= radixSortThreshold);
+        matching.addEdges(edges);
+        if (!matching.isComplete()) return Path(INFINITY);
     }
-    path.addToPath(getEdge(path.back(), path.front()));
+    return makePath(matching.getTour(0));
+}
+
+CityNetwork::Path CityNetwork::localSearch(const Path &start, unsigned int moves, LocalSearch::Policy policy) const {
+    if (!start.isValid() || start.getPathSize() != nodeCount || nodeCount < 5) return start;
+    const vector<int> &order = start.getOrder();
+    Tour tour(order, nodes.size());
+    LocalSearch search([this](int nodeId1, int nodeId2) { return getEdge(nodeId1, nodeId2).dist; }, getSearchCandidates(), policy);
+    if (moves & moveTwoOpt) search.addMove(make_unique<TwoOptMove>());
+    if (moves & moveOrOpt) search.addMove(make_unique<OrOptMove>());
+    if (moves & moveThreeOpt) search.addMove(make_unique<ThreeOptMove>());
+    search.run(tour);
+    return makePath(tour.getOrder(order.front()));
+}
+
+CityNetwork::Path CityNetwork::twoOpt(const Path &start) const {
+    return localSearch(start, moveTwoOpt);
+}
+
+CityNetwork::Path CityNetwork::linKernighan(const Path &start) const {
+    if (!start.isValid() || start.getPathSize() != nodeCount || nodeCount < 5) return start;
+    const vector<int> &order = start.getOrder();
+    Tour tour(order, nodes.size());
+    LinKernighan search([this](int nodeId1, int nodeId2) { return getEdge(nodeId1, nodeId2).dist; }, getSearchCandidates());
+    search.run(tour);
+    return makePath(tour.getOrder(order.front()));
+}
+
+CityNetwork::Path CityNetwork::iteratedLocalSearch(const Path &start, double seconds, const IteratedLocalSearch::ProgressFunction &progress) const {
+    if (!start.isValid() || start.getPathSize() != nodeCount || nodeCount < 5) return start;
+    const vector<int> &order = start.getOrder();
+    Tour tour(order, nodes.size());
+    IteratedLocalSearch search([this](int nodeId1, int nodeId2) { return getEdge(nodeId1, nodeId2).dist; }, getSearchCandidates());
+    search.run(tour, seconds, progress);
+    return makePath(tour.getOrder(order.front()));
+}
+
+CityNetwork::Path CityNetwork::islandSearch(double seconds, unsigned int islandCount, IslandModel::Result *result) const {
+    if (islandCount == 0) islandCount = threadCount;
+    if (nodeCount < 5 || nodes.empty() || nodes[0].id < 0) return Path(INFINITY);
+    // The constructive heuristics first, then nearest neighbor tours from random start nodes.
+    vector<function<Path()>> constructors = {
+        [this] { return greedyAlgorithm(); },
+        [this] { return nearestNeighbor(); },
+        [this] { return christofides(); },
+    };
+    if (graphType == graphLatLon) constructors.emplace_back([this] { return hilbertCurve(); });
+    constructors.emplace_back([this] { return candidateGreedyAlgorithm(); });
+    vector<vector<int>> starts;
+    for (size_t i = 0; i < constructors.size() && starts.size() < islandCount; i++) {
+        const Path path = constructors[i]();
+        if (!path.isValid() || path.getPathSize() != nodeCount) continue;
+        starts.push_back(path.getOrder());
+    }
+    vector<int> ids;
+    for (const Node &node : nodes)
+        if (node.id >= 0) ids.push_back(node.id);
+    mt19937 generator(1);
+    WorkspaceArena::Lease workspace = workspaces.acquire(nodes.size());
+    for (unsigned int attempts = 0; starts.size() < islandCount && attempts < 2 * islandCount; attempts++) {
+        vector<int> order = nearestNeighborOrder(ids[uniform_int_distribution<size_t>(0, ids.size() - 1)(generator)], *workspace);
+        if (!order.empty() && getEdge(order.back(), order.front()).dist != INFINITY) starts.push_back(order);
+    }
+    if (starts.empty()) return Path(INFINITY);
+    IslandModel model([this](int nodeId1, int nodeId2) { return getEdge(nodeId1, nodeId2).dist; }, getSearchCandidates(), nodes.size());
+    IslandModel::Result islandResult = model.run(starts, seconds);
+    rotate(islandResult.order.begin(), find(islandResult.order.begin(), islandResult.order.end(), 0), islandResult.order.end());
+    Path path = makePath(islandResult.order);
+    if (result != nullptr) *result = std::move(islandResult);
     return path;
 }
 
+vector<int> CityNetwork::getRealDistances(vector<double> &dist) const {
+    // The nodes get indexes 0 to V - 1 in ID order, so node 0 is the start, like in backtracking().
+    vector<int> ids;
+    for (const Node &node : nodes)
+        if (node.id >= 0) ids.push_back(node.id);
+    const int size = (int) ids.size();
+    dist.assign((size_t) size * size, INFINITY);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            if (i == j) continue;
+            const Edge edge = getEdge(ids[i], ids[j]);
+            if (edge.valid && edge.real) dist[(size_t) i * size + j] = edge.dist;
+        }
+    }
+    return ids;
+}
+
+CityNetwork::Path CityNetwork::heldKarp() const {
+    if (nodeCount > (unsigned int) HeldKarp::maxNodes || nodes.empty() || nodes[0].id < 0) return Path(INFINITY);
+    vector<double> dist;
+    const vector<int> ids = getRealDistances(dist);
+    const int size = (int) ids.size();
+    if (size < 2) return Path(INFINITY);
+    vector<int> order = HeldKarp::solve(dist, size, threadCount);
+    if (order.empty()) return Path(INFINITY);
+    for (int &nodeId : order) nodeId = ids[nodeId];
+    return makePath(order);
+}
+
+CityNetwork CityNetwork::subnetwork(unsigned int count) const {
+    CityNetwork network;
+    network.graphType = graphType;
+    network.threadCount = threadCount;
+    network.candidateCount = candidateCount;
+    for (const Node &node : nodes)
+        if (node.id >= 0 && node.id < (int) count) network.addNode(node);
+    network.distances.resize(network.nodes.size());
+    for (int id = 1; id < (int) network.nodes.size(); id++) {
+        for (int otherId = 0; otherId < id; otherId++) {
+            const Edge edge = getEdge(otherId, id);
+            if (!edge.valid) continue;
+            network.addEdge(edge);
+            if (!edge.real) network.fakeEdgeCount++;
+        }
+    }
+    if (graphType == graphLatLon) {
+        vector<double> lats, lons;
+        network.getCoordinates(lats, lons);
+        network.haversine.assign(lats, lons);
+    }
+    return network;
+}
+
+CityNetwork CityNetwork::subnetwork(const vector<int> &nodeIds) const {
+    CityNetwork network;
+    network.graphType = graphType;
+    network.threadCount = threadCount;
+    network.candidateCount = candidateCount;
+    Bitset kept(nodes.size());
+    for (size_t i = 0; i < nodeIds.size(); i++) {
+        if (!nodeExists(nodeIds[i])) throw std::out_of_range("There isn't a node " + to_string(nodeIds[i]) + "!");
+        if (kept.test(nodeIds[i])) throw std::invalid_argument("The node " + to_string(nodeIds[i]) + " is repeated!");
+        kept.set(nodeIds[i]);
+        Node node = nodes[nodeIds[i]];
+        node.id = (int) i;
+        network.addNode(node);
+    }
+    network.distances.resize(network.nodes.size());
+    for (int id = 1; id < (int) nodeIds.size(); id++) {
+        for (int otherId = 0; otherId < id; otherId++) {
+            const Edge edge = getEdge(nodeIds[otherId], nodeIds[id]);
+            if (!edge.valid) continue;
+            network.addEdge(Edge(otherId, id, edge.dist, edge.real));
+            if (!edge.real) network.fakeEdgeCount++;
+        }
+    }
+    if (graphType == graphLatLon) {
+        vector<double> lats, lons;
+        network.getCoordinates(lats, lons);
+        network.haversine.assign(lats, lons);
+    }
+    return network;
+}
+
+double CityNetwork::lowerBound() const {
+    lock_guard<mutex> lock(cacheLocks->lowerBound);
+    if (!isnan(cachedLowerBound)) return cachedLowerBound;
+    vector<int> ids;
+    for (const Node &node : nodes)
+        if (node.id >= 0) ids.push_back(node.id);
+    vector<double> fullRow;
+    OneTreeBound bound((int) ids.size(), [&](int index, vector<double> &row) {
+        getDistances(ids[index], fullRow);
+        row.resize(ids.size());
+        for (size_t i = 0; i < ids.size(); i++) row[i] = fullRow[ids[i]];
+    });
+    cachedLowerBound = bound.compute();
+    return cachedLowerBound;
+}
+
+double CityNetwork::optimalityGap(const Path &path) const {
+    if (!path.isValid()) return NAN;
+    const double bound = lowerBound();
+    if (!isfinite(bound) || bound <= 0) return NAN;
+    return 100 * (path.getDistance() / bound - 1);
+}
+
+CityNetwork::Path CityNetwork::makePath(vector<int> order) const {
+    vector<double> dists(order.size());
+    for (size_t pos = 0; pos < order.size(); pos++) dists[pos] = getEdge(order[pos], order[(pos + 1) % order.size()]).dist;
+    return Path(std::move(order), std::move(dists));
+}
+
+vector<CityNetwork::Edge> CityNetwork::getEdges(const Path &path) const {
+    const vector<int> &order = path.getOrder();
+    vector<Edge> edges;
+    edges.reserve(order.size());
+    for (size_t pos = 0; pos < order.size(); pos++) edges.push_back(getEdge(order[pos], order[(pos + 1) % order.size()]));
+    return edges;
+}
+
+CityNetwork::Path::Path(vector<int> order, vector<double> dists) :
+    order(std::move(order)), dists(std::move(dists)), distance(0) {
+    for (double dist : this->dists) distance += dist;
+    if (this->order.empty()) return;
+    positions.assign(*max_element(this->order.begin(), this->order.end()) + 1, -1);
+    for (size_t pos = 0; pos < this->order.size(); pos++) positions[this->order[pos]] = (int) pos;
+}
+
 ostream &operator<<(ostream &os, const CityNetwork &cityNet) {
     os << "Nodes: " << cityNet.nodeCount << '\n'
        << "Edge Count: " << cityNet.edgeCount;
@@ -356,10 +1005,11 @@ ostream &operator<<(ostream &os, const CityNetwork::Path &cityPath) {
     if (!cityPath.isValid()) os << "Invalid Path";
     else {
         os << "Path:\n";
-        for (const CityNetwork::Edge& e : cityPath.getPath()) {
-            string origin = to_string(e.origin); origin.append(max((int) (4 - origin.size()), (int) 0), ' ');
-            string dest = to_string(e.dest); dest.append(max((int) (4 - dest.size()), (int) 0), ' ');
-            os << origin << " -> " << dest << " [" << fixed << setprecision(2) << e.dist << "]\n";
+        const vector<int> &order = cityPath.getOrder();
+        for (size_t pos = 0; pos < order.size(); pos++) {
+            string origin = to_string(order[pos]); origin.append(max((int) (4 - origin.size()), (int) 0), ' ');
+            string dest = to_string(order[(pos + 1) % order.size()]); dest.append(max((int) (4 - dest.size()), (int) 0), ' ');
+            os << origin << " -> " << dest << " [" << fixed << setprecision(2) << cityPath.getDists()[pos] << "]\n";
         }
         os << "Total distance: " << fixed << setprecision(2) << cityPath.getDistance() << flush;
     }
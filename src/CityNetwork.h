@@ -1,12 +1,26 @@
 #ifndef CITYNETWORK_CITYNETWORK_H
 #define CITYNETWORK_CITYNETWORK_H
 
-#include <list>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <string_view>
 #include <utility>
 #include <vector>
 #include <cmath>
 #include "CSVReader.h"
+#include "Bitset.h"
+#include "DistanceMatrix.h"
+#include "HaversineKernel.h"
+#include "CandidateSet.h"
+#include "KdTree.h"
+#include "IslandModel.h"
+#include "IteratedLocalSearch.h"
+#include "LocalSearch.h"
+#include "Workspace.h"
 
 /**
  * @class CityNetwork
@@ -14,8 +28,11 @@
  *
  * The CityNetwork class manages a city network consisting of nodes and edges.
  * It provides various operations and algorithms for working with the city network.
+ * The network doesn't change after it is loaded: the algorithms keep their state in workspaces taken from an arena
+ * (see Workspace), so any number of them can run on the same network at once.
  */
 class CityNetwork {
+    friend class Snapshot;
     enum GraphType {
         graphNormal,
         graphLabeled,
@@ -34,7 +51,6 @@ public:
         int origin; /**< The ID of the origin node. */
         int dest; /**< The ID of the destination node. */
         double dist; /**< The distance between the origin and destination nodes. */
-        bool used = false; /**< Flag indicating if the edge is used in the greedy algorithm. */
         bool real; /**< Flag indicating if the edge is real, meaning it was given by the file when initializing. */
         bool valid; /**< Flag indicating if the edge is valid. */
         /**
@@ -60,16 +76,14 @@ public:
      * @brief Represents a node in the city network.
      *
      * The Node struct represents a node in the city network.
-     * It stores the ID of the node, a list of adjacent edges, label, latitude, longitude, and visited flag.
+     * It stores the ID of the node, label, latitude and longitude.
+     * The edges of the node are kept in the CityNetwork's distance matrix.
      */
     struct Node {
         int id; /**< The ID of the node. */
-        std::vector<Edge> adj; /**< The vector of adjacent edges. */
         std::string label; /**< The label of the node. */
         double lat; /**< The latitude of the node. */
         double lon; /**< The longitude of the node. */
-        int prev = -1; /**< Value used to calculate MST. (Previous Node ID) */
-        bool visited = false; /**< Flag indicating if the node has been visited. */
         /**
           * @brief Default constructor.
           *
@@ -77,29 +91,23 @@ public:
           */
         Node() : id(-1), lat(INFINITY), lon(INFINITY) {};
         /**
-         * @brief Constructs a node with the given ID and the adjacent nodes (empty if none given).
+         * @brief Constructs a node with the given ID.
          * @param id The ID of the node.
-         * @param adj The vector of adjacent edges.
          */
-        explicit Node(int id, std::vector<Edge> adj = {}) :
-            id(id), adj(std::move(adj)), lat(INFINITY), lon(INFINITY) {}
+        explicit Node(int id) : id(id), lat(INFINITY), lon(INFINITY) {}
         /**
-         * @brief Constructs a node with the given ID, label and the adjacent nodes (empty if none given).
+         * @brief Constructs a node with the given ID and label.
          * @param id The ID of the node.
          * @param label The label of the node.
-         * @param adj The vector of adjacent edges.
          */
-        Node(int id, std::string label, std::vector<Edge> adj = {}) :
-            id(id), label(std::move(label)), adj(std::move(adj)), lat(INFINITY), lon(INFINITY) {}
+        Node(int id, std::string label) : id(id), label(std::move(label)), lat(INFINITY), lon(INFINITY) {}
         /**
-         * @brief Constructs a node with the given ID, latitude, longitude and the adjacent nodes (empty if none given).
+         * @brief Constructs a node with the given ID, latitude and longitude.
          * @param id The ID of the node.
          * @param lat The latitude of the node.
          * @param lon The longitude of the node.
-         * @param adj The vector of adjacent edges.
          */
-        Node(int id, double lat, double lon, std::vector<Edge> adj = {}) :
-            id(id), lat(lat), lon(lon), adj(std::move(adj)) {}
+        Node(int id, double lat, double lon) : id(id), lat(lat), lon(lon) {}
 
         /**
          * @brief Overload of the subtraction operator between Nodes to mean the calculation of the haversine distance between the two nodes.
@@ -122,68 +130,121 @@ public:
         }
     };
 
+    /**
+     * @class Adjacency
+     * @brief A view over the edges of a node, read from the distance matrix.
+     *
+     * Iterating it yields, in order of destination ID, one Edge for every node of the network.
+     * Pairs without an edge yield an invalid Edge, just like an unset slot of an adjacency vector would.
+     * When the edges are computed on demand, each one is computed only when the iterator is dereferenced.
+     */
+    class Adjacency {
+        const CityNetwork& network; /**< The network the node belongs to. */
+        int nodeId; /**< The ID of the node. */
+    public:
+        /**
+         * @brief Forward iterator over the edges of the node.
+         *
+         * The position in the triangular array is updated incrementally: it moves by one while the destination
+         * is below the node (contiguous row) and by the destination's ID once it is above it (column).
+         */
+        class iterator {
+            const CityNetwork* network; /**< The network the node belongs to. */
+            const DistanceMatrix* distances; /**< The distance matrix of the network. */
+            int nodeId; /**< The ID of the node. */
+            int destId; /**< The ID of the destination of the current edge. */
+            size_t pairIndex; /**< The position of the current pair in the distance matrix. */
+        public:
+            iterator(const CityNetwork* network, int nodeId, int destId) :
+                network(network), distances(&network->distances), nodeId(nodeId), destId(destId),
+                pairIndex(destId == nodeId ? 0 : DistanceMatrix::index(nodeId, destId)) {}
+            Edge operator*() const {
+                if (network->edgesOnDemand) return network->getEdge(nodeId, destId);
+                if (destId == nodeId || !distances->isValidAt(pairIndex)) return {};
+                return {nodeId, destId, distances->getDistAt(pairIndex), distances->isRealAt(pairIndex)};
+            }
+            iterator& operator++() {
+                if (destId + 1 == nodeId) pairIndex = 0; // Skips the diagonal.
+                else if (destId == nodeId) pairIndex = DistanceMatrix::index(nodeId, nodeId + 1);
+                else if (destId < nodeId) pairIndex++;
+                else pairIndex += destId;
+                destId++;
+                return *this;
+            }
+            bool operator!=(const iterator& other) const { return destId != other.destId; }
+        };
+        /**
+         * @brief Constructs the view over the edges of a node.
+         * @param network The network the node belongs to.
+         * @param nodeId The ID of the node.
+         */
+        Adjacency(const CityNetwork& network, int nodeId) : network(network), nodeId(nodeId) {}
+        [[nodiscard]] iterator begin() const { return {&network, nodeId, 0}; }
+        [[nodiscard]] iterator end() const { return {&network, nodeId, (int) network.nodes.size()}; }
+    };
+
     /**
      * @class Path
      * @brief Represents a path in the city network.
      *
-     * The Path class represents a path in the city network.
-     * It stores a list of edges that form the path and the total distance of the path.
+     * The Path class represents a closed path (a cycle) in the city network.
+     * It stores the IDs of the nodes in visiting order, contiguously, the distance of every hop (from every node to the
+     * next one and from the last node back to the first), the total distance of the path and the position of every
+     * node in the order. It holds no reference to its network, so it can outlive it; the edges themselves are built by
+     * the network when they are asked for (see CityNetwork::getEdges()).
      */
     class Path {
-        std::list<Edge> path; /**< The list of edges forming the path. */
+        std::vector<int> order; /**< The IDs of the nodes, in visiting order. */
+        std::vector<int> positions; /**< The position of every node in the order, by ID (-1 if it isn't on the path). */
+        std::vector<double> dists; /**< The distance of every hop, from the node at the same position to the next one. */
         double distance; /**< The total distance of the path. */
 
     public:
         /**
-         * @brief Default constructor.
-         *
-         * Constructs an empty path with zero distance.
+         * @brief Constructs an empty path (by default with zero distance, INFINITY for an invalid path).
+         * @param distance The total distance of the path.
          */
-        explicit Path(std::list<Edge> path = {}, double distance = 0.0) :
-            path(std::move(path)), distance(distance) {}
+        explicit Path(double distance = 0.0) : distance(distance) {}
         /**
-         * @brief Get the list of edges forming the path.
-         * @return The list of edges forming the path.
+         * @brief Constructs a path from the IDs of its nodes and the distances of its hops.
+         * @param order The IDs of the nodes, in visiting order.
+         * @param dists The distance of every hop, from the node at the same position to the next one (the last one back
+         * to the first node).
          */
-        [[nodiscard]] const std::list<Edge>& getPath() const { return path; }
+        Path(std::vector<int> order, std::vector<double> dists);
+        /**
+         * @brief Get the IDs of the nodes of the path, in visiting order.
+         * @return The IDs of the nodes of the path.
+         */
+        [[nodiscard]] const std::vector<int>& getOrder() const { return order; }
+        /**
+         * @brief Get the distances of the hops of the path, from the first node back to itself.
+         * @return The distance of every hop, by the position of its origin.
+         */
+        [[nodiscard]] const std::vector<double>& getDists() const { return dists; }
         /**
         * @brief Get the total distance of the path.
         * @return The total distance of the path.
         */
         [[nodiscard]] double getDistance() const { return distance; }
         /**
-         * @brief Get the number of edges in the path.
+         * @brief Get the number of edges in the path (the same as its number of nodes).
          * @return The number of edges in the path.
          */
-        [[nodiscard]] size_t getPathSize() const { return path.size(); }
+        [[nodiscard]] size_t getPathSize() const { return order.size(); }
         /**
-         * @brief Check if the path is valid (i.e. has a finite distance).
-         * @return True if the path is valid, false otherwise.
+         * @brief Gets the position of a node in the visiting order, in constant time.
+         * @param nodeId The ID of the node.
+         * @return The position of the node (-1 if it isn't on the path).
          */
-        [[nodiscard]] bool isValid() const { return distance != INFINITY; }
-        /**
-         * @brief Add an edge to the path and update the total distance.
-         * @param edge The edge to add to the path.
-         */
-        void addToPath(Edge edge) {
-            path.push_back(edge);
-            distance += edge.dist;
+        [[nodiscard]] int getPosition(int nodeId) const {
+            return nodeId >= 0 && nodeId < (int) positions.size() ? positions[nodeId] : -1;
         }
         /**
-         * @brief Remove the last edge from the path and update the total distance.
+         * @brief Check if the path is valid (i.e. has a finite distance).
+         * @return True if the path is valid, false otherwise.
          */
-        void removeLast() {
-            distance -= path.back().dist;
-            path.pop_back();
-        }
-        /**
-         * @brief Returns the origin of the whole path.
-         * */
-        int front() { return this->path.front().origin; }
-        /**
-         * @brief Returns the destination of the whole path.
-         * */
-         int back() { return this->path.back().dest; }
+        [[nodiscard]] bool isValid() const { return distance != INFINITY; }
         /**
          * @brief Compare two paths based on their total distance.
          * @param pathObj The path object to compare with.
@@ -196,32 +257,132 @@ public:
 
 private:
     std::vector<Node> nodes; /**< The list of nodes in the city network. */
+    DistanceMatrix distances; /**< The edges of the city network, one entry per pair of nodes. */
+    bool lazyEdges; /**< Setting: whether coordinate datasets compute their missing edges on demand. */
+    bool memoizeEdges; /**< Setting: whether the edges computed on demand are cached. */
+    bool edgesOnDemand; /**< Whether the loaded network computes its missing edges on demand (then distances is empty). */
+    std::unordered_map<size_t, double> sparseEdges; /**< The real edges, by pair index, when the edges are computed on demand. */
+    /**
+     * @struct CachedDistance
+     * @brief A slot of the cache of distances computed on demand.
+     *
+     * Threads read and write the slots without locks. The slot keeps the pair index XORed with the bits of the
+     * distance, so a slot torn by two threads writing it at once doesn't match its pair and is just recomputed.
+     */
+    struct CachedDistance {
+        std::atomic<uint64_t> check; /**< The pair the distance belongs to XOR the bits of dist (SIZE_MAX if empty). */
+        std::atomic<double> dist; /**< The distance. */
+        CachedDistance();
+        CachedDistance(const CachedDistance& other);
+        CachedDistance& operator=(const CachedDistance& other);
+    };
+    mutable std::vector<CachedDistance> distanceCache; /**< Direct-mapped cache of the distances computed on demand. */
+    HaversineKernel haversine; /**< Computes the distances between the nodes of coordinate datasets. */
+    static constexpr size_t radixSortThreshold = 1 << 16; /**< The number of edges from which the greedy algorithm radix sorts them. */
+    static constexpr int quadrantPool = 4; /**< How many times candidateCount nearest nodes the quadrants are filled from, on demand. */
     unsigned int nodeCount; /**< The total number of nodes in the city network. */
     unsigned long long edgeCount; /**< The total number of edges in the city network. */
     unsigned long long fakeEdgeCount; /**< The number of fake edges (i.e. edges that were not given by the user's file) in the city network. */
+    unsigned int threadCount; /**< The number of threads the parallel parts (e.g. loading) may use. */
+    bool useSnapshots; /**< Whether datasets are saved to and loaded from binary snapshots. */
+    int candidateCount; /**< Setting: the number of nearest neighbours kept per node by the candidate heuristics. */
+    mutable CandidateSet candidates; /**< The nearest neighbours of every node, built on first use. */
+    mutable CandidateSet searchCandidates; /**< The quadrant neighbours of every node of coordinate datasets, built on first use. */
+    mutable KdTree spatialIndex; /**< The nodes of coordinate datasets on the unit sphere, built on first use. */
+    mutable double cachedLowerBound; /**< The Held-Karp lower bound of the tour length, NAN until it is computed. */
+    /**
+     * @struct CacheLocks
+     * @brief Guard the data built on first use, so that only one of the algorithms running at once builds it.
+     */
+    struct CacheLocks {
+        std::mutex candidates; /**< Guards candidates. */
+        std::mutex searchCandidates; /**< Guards searchCandidates. */
+        std::mutex spatialIndex; /**< Guards spatialIndex. */
+        std::mutex lowerBound; /**< Guards cachedLowerBound. */
+    };
+    std::shared_ptr<CacheLocks> cacheLocks; /**< The locks of the data built on first use (shared by copies). */
+    mutable WorkspaceArena workspaces; /**< The scratch state of the algorithms running, reused between runs. */
+
+    /**
+     * @struct EdgeRecord
+     * @brief An edge as read from a CSV line, before being added to the network.
+     *
+     * The labels are views into the mapped file and are only set for labeled graphs.
+     */
+    struct EdgeRecord {
+        int origin; /**< The ID of the origin node. */
+        int dest; /**< The ID of the destination node. */
+        double dist; /**< The distance between the nodes. */
+        std::string_view originLabel; /**< The label of the origin node. */
+        std::string_view destLabel; /**< The label of the destination node. */
+    };
+
+    /**
+     * @brief Parses a CSV line into an edge record.
+     * @param line The fields of the line.
+     * @param columns The number of columns the line must have (3, or 5 if it has labels).
+     * @param errorMessage The message of the exception thrown if the line isn't formatted correctly.
+     * @return The edge record.
+     */
+    static EdgeRecord parseEdgeRecord(const CSVFields& line, size_t columns, const char* errorMessage);
+    /**
+     * @brief Adds the edge of a record to the city network.
+     * @param record The edge record.
+     * @param createNodes Whether to create the nodes of the edge that don't exist yet (with the record's labels, if any).
+     */
+    void addEdgeRecord(const EdgeRecord& record, bool createNodes);
+    /**
+     * @brief Reads every edge line between begin and end and adds it to the city network.
+     *
+     * Large inputs are split into newline-aligned ranges that are parsed by threadCount threads into local buffers,
+     * which are then added in file order, so the result is identical to reading the lines one by one.
+     * @param begin The first character to read.
+     * @param end The character past the last one to read.
+     * @param columns The number of columns every line must have (3, or 5 if it has labels).
+     * @param createNodes Whether to create the nodes of the edges that don't exist yet.
+     * @param errorMessage The message of the exception thrown if a line isn't formatted correctly.
+     */
+    void readEdges(const char* begin, const char* end, size_t columns, bool createNodes, const char* errorMessage);
 
     /**
      * @brief Initialize the edges of the city network from a CSV file.
-     * @param edgesCSV The CSV object containing edge data.
+     *
+     * The file is memory-mapped and each line is parsed in place and added straight to the network.
+     * @param edgesFile The path to the CSV file containing edge data.
      */
-    void initializeEdges(const CSV& edgesCSV);
+    void initializeEdges(const std::string& edgesFile);
 
     /**
      * @brief Initialize the nodes of the city network from a CSV file.
-     * @param nodesCSV The CSV object containing node data.
+     * @param nodesFile The path to the CSV file containing node data.
      */
-    void initializeNodes(const CSV& nodesCSV);
+    void initializeNodes(const std::string& nodesFile);
 
     /**
-     * @brief Initialize the city network from CSV files.
-     * @param networkCSV The CSV object containing network data.
+     * @brief Initialize the city network from a single CSV file, setting the graph type by its number of columns.
+     * @param networkFile The path to the CSV file containing network data.
      */
-    void initializeNetwork(const CSV& networkCSV);
+    void initializeNetwork(const std::string& networkFile);
 
     /**
      * @brief Clear the data of the city network.
      */
     void clearData();
+    /**
+     * @brief Computes the haversine distance between two different nodes, through the cache if memoization is on.
+     * @param nodeId1 The ID of the first node.
+     * @param nodeId2 The ID of the second node.
+     * @return The distance between the nodes.
+     */
+    double computeDistance(int nodeId1, int nodeId2) const;
+    /**
+     * @brief Gets the distance from a node to every node of the city network.
+     *
+     * For edges computed on demand the whole row is computed in one batch by the haversine kernel.
+     * @param nodeId The ID of the node.
+     * @param row Where the distances are written, indexed by destination ID (INFINITY if there is no edge).
+     */
+    void getDistances(int nodeId, std::vector<double>& row) const;
     /**
      * @brief Add a node to the city network.
      * @param node The node to add.
@@ -241,83 +402,93 @@ private:
     /**
      * @brief Get the adjacent edges of a node.
      * @param nodeId The ID of the node.
-     * @return The vector of adjacent edges.
+     * @return A view over the adjacent edges.
      */
-    std::vector<Edge>& getAdj(int nodeId);
+    [[nodiscard]] Adjacency getAdj(int nodeId) const;
     /**
      * @brief Get the edge between two nodes.
      * @param nodeId1 The ID of the first node.
      * @param nodeId2 The ID of the second node.
-     * @return The edge between the two nodes.
+     * @return The edge between the two nodes (an invalid edge if there is none).
      */
-    Edge& getEdge(int nodeId1, int nodeId2);
+    [[nodiscard]] Edge getEdge(int nodeId1, int nodeId2) const;
     /**
-     * @brief Check if a node exists in the city network.
-     * @param nodeId The ID of the node.
-     * @return True if the node exists, false otherwise.
+     * @brief Finds the nearest neighbor tour from a start node.
+     * @param startId The ID of the start node.
+     * @param workspace The workspace of the run, as given by the arena (its visited flags and row are used).
+     * @return The IDs of the nodes in visiting order, from the start node (empty if the tour gets stuck).
      */
-    bool nodeExists(int nodeId);
+    std::vector<int> nearestNeighborOrder(int startId, Workspace& workspace) const;
     /**
-     * @brief Clear the visited flag of all nodes in the city network.
+     * @brief Builds the cycle that visits the given nodes in order and returns to the first one.
+     * @param order The IDs of the nodes, in visiting order.
+     * @return The path.
      */
-    void clearVisits();
+    [[nodiscard]] Path makePath(std::vector<int> order) const;
     /**
-     * @brief Check if a node has been visited.
-     * @param nodeId The ID of the node.
-     * @return true if the node has been visited, false otherwise.
+     * @brief Builds the dense distance matrix of the real edges used by the exact solvers.
+     * @param dist Set to the distance from the i-th to the j-th node (in ID order) at i * V + j, INFINITY if there is
+     * no real edge between them.
+     * @return The ID of every node, in order (so node 0 is the first).
      */
-    bool isVisited(int nodeId);
+    std::vector<int> getRealDistances(std::vector<double>& dist) const;
     /**
-     * @brief Mark a node as visited.
-     * @param nodeId The ID of the node.
+     * @brief Gets the candidate lists (the candidateCount nearest neighbours of every node), building them if needed.
+     *
+     * Building them takes O(V^2) time, split among the threads, and they are kept until the data is reloaded or the
+     * candidate count changes. Coordinate datasets whose edges are all computed on demand query the spatial index
+     * instead, in O(V*k*log(V)) time.
+     * @return The candidate lists.
      */
-    void visit(int nodeId);
+    const CandidateSet& getCandidates() const;
     /**
-     * @brief Mark a node as unvisited.
-     * @param nodeId The ID of the node.
+     * @brief Gets the candidate lists of the local searches, building them if needed: for coordinate datasets the
+     * nearest neighbours of every quadrant around each node (see CandidateSet::assignQuadrants()), which let them join
+     * clusters, else the nearest neighbours (see getCandidates()).
+     *
+     * Building them takes the same time as getCandidates(). When the edges are all computed on demand, the quadrants
+     * are filled from the quadrantPool * candidateCount nearest nodes of the spatial index.
+     * @return The candidate lists.
      */
-    void unvisit(int nodeId);
-
+    const CandidateSet& getSearchCandidates() const;
     /**
-    * @brief Clear the prev attribute of all nodes in the city network.
-    */
-    void clearPrevs();
-    /**
-     * @brief Gets the previous node id (prev attribute).
-     * @param nodeId The Node it's going to get the prev attribute from.
-     * @return The previous node id.
+     * @brief Builds candidate lists of candidateCount nodes, splitting the nodes among the threads.
+     * @param set The lists.
+     * @param quadrants Whether they take the nearest neighbours of every quadrant (see getSearchCandidates()).
      */
-    int getPrev(int nodeId);
+    void buildCandidates(CandidateSet& set, bool quadrants) const;
     /**
-     * @brief Sets the Node's prev attribute to the given value.
-     * @param nodeId The Node's ID.
-     * @param prev The previous Node ID.
+     * @brief Gets the spatial index of a coordinate dataset, building it if needed.
+     * @return The k-d tree of the nodes.
      */
-    void setPrev(int nodeId, int prev);
-    /**
-    * @brief Clear the used attribute of all edges in the city network.
-    */
-    void clearUses();
+    const KdTree& getSpatialIndex() const;
     /**
-     * @brief Checks if an edge is used.
-     * @param originId The origin Node's ID.
-     * @param destId The destination Node's ID.
-     * @return true if edge is used, false otherwise.
+     * @brief Gets the coordinates of every node, indexed by ID (INFINITY for missing IDs).
+     * @param lats Set to the latitudes.
+     * @param lons Set to the longitudes.
      */
-    bool isUsed(int originId, int destId);
+    void getCoordinates(std::vector<double>& lats, std::vector<double>& lons) const;
     /**
-     * @brief Sets edge used attribute to true.
-     * @param originId The origin Node's ID.
-     * @param destId The destination Node's ID.
+     * Calculates the pre-order traversing order of the MST starting at the root Node given.
+     * @param rootId The root Node's ID.
+     * @param workspace The workspace of the run, as given by the arena.
+     * @return The traversing order.
+     *
+     * The parent of every node in the tree is left in the workspace's parents (-1 for the root and the nodes not
+     * reached). Complete graphs (no fake edges) use calcDenseMST(), which does the same over all the edges.
      */
-    void use(int originId, int destId);
+    std::vector<int> calcMST(int rootId, Workspace& workspace) const;
     /**
-     * Calculates the pre-order traversing order of the MST starting at the root Node given.
+     * @brief Calculates the same pre-order as calcMST() on a complete graph, with the array version of Prim's
+     * algorithm: a key per node, scanned linearly for the minimum, and the children of every node kept in lists for
+     * the walk.
      * @param rootId The root Node's ID.
+     * @param workspace The workspace of the run, as given by the arena.
      * @return The traversing order.
      *
+     * The time complexity is O(V^2), with O(V) extra memory (instead of a heap of up to V^2 edges).
      */
-    std::vector<int> calcMST(int rootId);
+    std::vector<int> calcDenseMST(int rootId, Workspace& workspace) const;
     /**
      * @brief Completes the graph with fake edges not given by the user.
      */
@@ -326,11 +497,34 @@ private:
     /**
      * @brief Recursive helper function for the backtracking algorithm.
      * @param currNodeId The ID of the current node.
-     * @param currentPath The current path being explored.
+     * @param order The nodes of the current path being explored, in visiting order (restored before returning).
+     * @param distance The distance of the current path.
+     * @param visited The nodes on the current path.
      * @param bestPath The best path found so far.
      */
-    void backtrackingHelper(int currNodeId, Path currentPath, Path& bestPath);
+    void backtrackingHelper(int currNodeId, std::vector<int>& order, double distance, Bitset& visited, Path& bestPath) const;
 public:
+    static constexpr unsigned int maxThreadCount = 1024; /**< The most threads setThreadCount() allows. */
+    static constexpr int maxCandidateCount = 50; /**< The most candidates per node setCandidateCount() allows. */
+
+    /**
+     * @brief The moves localSearch() can use, combined as flags.
+     */
+    enum LocalSearchMove {
+        moveTwoOpt = 1, /**< 2-opt (see TwoOptMove). */
+        moveOrOpt = 2, /**< Or-opt (see OrOptMove). */
+        moveThreeOpt = 4, /**< Restricted 3-opt (see ThreeOptMove). */
+    };
+
+    /**
+     * @brief How christofides() matches the odd-degree nodes of the MST.
+     */
+    enum MatchingMethod {
+        matchingAuto, /**< Exact for up to PerfectMatching::exactLimit odd nodes, greedy for more. */
+        matchingExact, /**< Minimum-weight perfect matching (see PerfectMatching::exact()). */
+        matchingGreedy /**< Closest pairs first (see PerfectMatching::greedy()). */
+    };
+
     /**
      * @brief Default constructor.
      *
@@ -347,41 +541,287 @@ public:
 
     /**
      * @brief Initializes the CityNetwork object with data from a CSV file or directory of CSV files.
+     *
+     * If snapshots are enabled, an up-to-date snapshot of the dataset is loaded instead of the CSV files,
+     * and a new snapshot is written after loading from the CSV files.
      * @param datasetPath The path to the directory containing the CSV files or the path to a single CSV file.
      * @param isDirectory Flag indicating if the datasetPath is a directory.
      */
     void initializeData(const std::string& datasetPath, bool isDirectory);
 
+    /**
+     * @brief Check if a node exists in the city network.
+     * @param nodeId The ID of the node.
+     * @return True if the node exists, false otherwise.
+     */
+    [[nodiscard]] bool nodeExists(int nodeId) const;
+
+    /**
+     * @brief Sets the number of threads the parallel parts (e.g. loading) may use.
+     * @param count The number of threads (1 to maxThreadCount, clamped).
+     */
+    void setThreadCount(unsigned int count);
+    /**
+     * @brief Gets the number of threads the parallel parts (e.g. loading) may use.
+     * @return The number of threads.
+     */
+    [[nodiscard]] unsigned int getThreadCount() const { return threadCount; }
+    /**
+     * @brief Gets the number of nodes of the city network.
+     * @return The number of nodes.
+     */
+    [[nodiscard]] unsigned int getNodeCount() const { return nodeCount; }
+    /**
+     * @brief Sets whether datasets are saved to and loaded from binary snapshots (see Snapshot).
+     * @param enabled true to use snapshots, false to always load from the CSV files.
+     */
+    void setUseSnapshots(bool enabled) { useSnapshots = enabled; }
+    /**
+     * @brief Sets the number of nearest neighbours the candidate heuristics consider per node.
+     * @param count The number of candidates (1 to maxCandidateCount, clamped).
+     */
+    void setCandidateCount(int count);
+    /**
+     * @brief Gets the number of nearest neighbours the candidate heuristics consider per node.
+     * @return The number of candidates.
+     */
+    [[nodiscard]] int getCandidateCount() const { return candidateCount; }
+    /**
+     * @brief Sets whether coordinate datasets (nodes.csv + edges.csv) compute their missing edges on demand.
+     *
+     * Eagerly, completeEdges() stores the haversine distance of every missing pair, taking O(V^2) time and memory.
+     * On demand, only the given edges are stored and the others are computed whenever they are accessed,
+     * optionally caching them in a fixed-size cache. Takes effect on the next initializeData.
+     * @param lazy true to compute the missing edges on demand.
+     * @param memoize true to cache the edges computed on demand.
+     */
+    void setLazyEdges(bool lazy, bool memoize = false);
+    /**
+     * @brief Checks if coordinate datasets compute their missing edges on demand.
+     * @return true if they do, false otherwise.
+     */
+    [[nodiscard]] bool getLazyEdges() const { return lazyEdges; }
+    /**
+     * @brief Checks if the edges computed on demand are cached.
+     * @return true if they are, false otherwise.
+     */
+    [[nodiscard]] bool getMemoizeEdges() const { return memoizeEdges; }
+
     /**
      * @brief Perform the backtracking algorithm to find the shortest path in the city network.
      * @return The shortest path.
      *
      * The time complexity of the backtracking algorithm is O((V - 1)!).
      */
-    Path backtracking();
+    Path backtracking() const;
+    /**
+     * @brief Finds the shortest path by branch and bound (see BranchAndBound), the same one backtracking() finds.
+     * @return The shortest path.
+     *
+     * The nearest neighbor and greedy tours give the first upper bound, and branches whose lower bound exceeds the best
+     * tour found are cut. The time complexity is still O((V - 1)!) in the worst case, but far less in practice.
+     */
+    Path branchAndBound() const;
     /**
      * @brief Perform the triangular approximation heuristic algorithm to find an approximate shortest path in the city network.
      * @return The approximate shortest path.
      *
      * The time complexity of the triangular approximation heuristic algorithm is O(E*log(V)).
      */
-    Path triangularApproximation();
+    Path triangularApproximation() const;
+
+    /**
+     * @brief Performs Christofides' algorithm: the MST (from calcDenseMST(), over all the edges like the other
+     * heuristics), a perfect matching of its odd-degree nodes, an Eulerian circuit of both and the tour that skips the
+     * nodes already visited on it.
+     * @param method How the odd-degree nodes are matched.
+     * @return The approximate shortest path (an invalid path if the edges don't connect the nodes or the odd nodes have
+     * no perfect matching).
+     *
+     * With the exact matching, the tour is at most 1.5 times the optimal one when the distances obey the triangle
+     * inequality. The time complexity is O(V^2) for the MST, O(K^3) for the exact matching or O(K^2*log(K)) for the
+     * greedy one, with K odd-degree nodes, and O(V) for the circuit.
+     */
+    Path christofides(MatchingMethod method = matchingAuto) const;
 
     /**
      * @brief Performs the nearest neighbor algorithm to find an approximate shortest path in the city network.
-     * @return The approximate shortest path.
+     * @param startId The ID of the node the tour starts at.
+     * @return The approximate shortest path (an invalid path if the start node doesn't exist).
      *
      * The time complexity of the nearest neighbor algorithm is O(V).
      * */
-    Path nearestNeighbor();
+    Path nearestNeighbor(int startId = 0) const;
+
+    /**
+     * @brief Runs the nearest neighbor algorithm from several start nodes at once, on the threads, and keeps the
+     * shortest tour.
+     * @param startCount The number of start nodes, evenly spaced among the IDs and always including node 0 (0 to start
+     * from every node).
+     * @return The shortest of the tours, rotated to start at node 0 (the first start on ties).
+     *
+     * The time complexity is O(S*V^2) for S start nodes, split among the threads.
+     * */
+    Path multiStartNearestNeighbor(unsigned int startCount = 0) const;
 
     /**
      * @brief Performs the greedy algorithm to find an approximate shortest path in the city network.
      * @return The approximate shortest path.
      *
-     * The time complexity of the greedy algorithm is O(E*V)
+     * Edges are taken from shortest to longest (ties by node IDs) while no node gets more than 2 of them and no cycle
+     * is closed before the last edge. Fragments are tracked with a disjoint-set forest and the candidate edges are
+     * sorted once, with a radix sort for large graphs. When the edges are computed on demand, storing every pair would
+     * take O(V^2) memory, so candidateGreedyAlgorithm() is used instead.
+     *
+     * The time complexity of the greedy algorithm is O(E log E), O(E) with the radix sort.
+     * */
+    Path greedyAlgorithm() const;
+
+    /**
+     * @brief Performs the nearest neighbor algorithm looking only at the candidate lists.
+     * @return The approximate shortest path.
+     *
+     * The next node is the first unvisited candidate of the current one, which is the same node the full algorithm
+     * picks, so the tour is the same. Only when every candidate was visited are all the nodes scanned.
+     *
+     * The time complexity is O(V*k) plus O(V) per full scan, after building the candidate lists.
+     * */
+    Path candidateNearestNeighbor() const;
+
+    /**
+     * @brief Performs the nearest neighbor algorithm on coordinate datasets with a k-d tree over the nodes.
+     * @return The approximate shortest path.
+     *
+     * The next node is the one nearest to the current one by great-circle distance, found in the tree, and visited
+     * nodes are removed from it. No distance matrix row is scanned, so it also suits datasets whose edges are computed
+     * on demand. Nodes are chosen by their coordinates, so real edges with other distances don't affect the choice
+     * (they are still used for the distance of the path). Other datasets use nearestNeighbor().
+     *
+     * The time complexity is O(V*log(V)) on average.
+     * */
+    Path spatialNearestNeighbor() const;
+
+    /**
+     * @brief Performs the greedy algorithm looking only at the candidate edges.
+     * @return The approximate shortest path.
+     *
+     * The candidate edges (at most V*k) are matched like in greedyAlgorithm(). The fragments left when they run out are
+     * then joined with the edges between their ends only.
+     *
+     * The time complexity is O(V*k*log(V*k) + F^2*log(F)), with F fragment ends, after building the candidate lists.
+     * */
+    Path candidateGreedyAlgorithm() const;
+
+    /**
+     * @brief Visits the nodes of a coordinate dataset in the order of a Hilbert curve over their coordinates (see
+     * HilbertCurve), rotated to start at node 0.
+     * @return The approximate shortest path.
+     *
+     * No distance is computed to build the tour (only to add up its length), so it suits huge datasets whose edges are
+     * computed on demand, e.g. as the starting tour of localSearch() or linKernighan(). Other datasets use
+     * nearestNeighbor().
+     *
+     * The time complexity is O(V*log(V)).
+     * */
+    Path hilbertCurve() const;
+
+    /**
+     * @brief Improves a tour with the given local search moves (see LocalSearch), using the search candidate lists (see
+     * getSearchCandidates()) as neighbour lists.
+     * @param start The tour to improve, e.g. the result of one of the heuristics.
+     * @param moves The moves to use (a combination of LocalSearchMove flags).
+     * @param policy Whether to make the first or the best improving move found around each node.
+     * @return The improved tour, starting at the same node (the start tour itself if it isn't a valid tour).
+     *
+     * The time complexity is about O(V*k) per pass over the tour for 2-opt and Or-opt, O(V*k^2) for 3-opt, after
+     * building the candidate lists.
+     * */
+    Path localSearch(const Path& start, unsigned int moves, LocalSearch::Policy policy = LocalSearch::firstImprovement) const;
+
+    /**
+     * @brief Improves a tour with 2-opt moves only (see localSearch()).
+     * @param start The tour to improve.
+     * @return The improved tour.
+     * */
+    Path twoOpt(const Path& start) const;
+
+    /**
+     * @brief Improves a tour with Lin-Kernighan style variable-depth moves (see LinKernighan), using the search
+     * candidate lists (see getSearchCandidates()) as neighbour lists.
+     * @param start The tour to improve, e.g. the result of one of the heuristics.
+     * @return The improved tour, starting at the same node (the start tour itself if it isn't a valid tour).
+     * */
+    Path linKernighan(const Path& start) const;
+
+    /**
+     * @brief Keeps improving a tour until a time budget runs out, with Lin-Kernighan and double bridge kicks (see
+     * IteratedLocalSearch), using the search candidate lists (see getSearchCandidates()) as neighbour lists.
+     * @param start The tour to improve, e.g. the result of one of the heuristics.
+     * @param seconds The time budget, in seconds (building the candidate lists isn't counted).
+     * @param progress Called with the best tour so far when it improves (see IteratedLocalSearch::run()), may be empty.
+     * @return The best tour found, starting at the same node (the start tour itself if it isn't a valid tour).
+     * */
+    Path iteratedLocalSearch(const Path& start, double seconds, const IteratedLocalSearch::ProgressFunction& progress = nullptr) const;
+
+    /**
+     * @brief Runs an iterated local search on every thread (see IslandModel), the islands starting from the greedy,
+     * nearest neighbor, Christofides, Hilbert curve (coordinate datasets) and candidate greedy tours, then from nearest
+     * neighbor tours from random start nodes, and sharing their best tours.
+     * @param seconds The time budget, in seconds (building the start tours and the candidate lists isn't counted).
+     * @param islandCount The number of islands (0 for one per thread).
+     * @param result Set to the best tour and the work done (e.g. the number of tours evaluated), may be null.
+     * @return The best tour found, starting at node 0 (an invalid path if no start tour could be built).
+     * */
+    Path islandSearch(double seconds, unsigned int islandCount = 0, IslandModel::Result* result = nullptr) const;
+
+    /**
+     * @brief Finds the shortest path with the Held-Karp dynamic programming (see HeldKarp), using only the real edges
+     * and starting at node 0, like backtracking().
+     * @return The shortest path (an invalid path if there is none or if there are more than HeldKarp::maxNodes nodes).
+     *
+     * The time complexity is O(2^V*V^2), split among the threads, and it takes HeldKarp::memoryUsage(V) bytes.
+     * */
+    Path heldKarp() const;
+
+    /**
+     * @brief Copies the part of the city network made of the nodes with the lowest IDs (e.g. to time the exact
+     * algorithms on growing sizes).
+     * @param count The number of node IDs kept (the nodes 0 to count - 1).
+     * @return The city network with those nodes and the edges between them, fake ones included.
+     */
+    [[nodiscard]] CityNetwork subnetwork(unsigned int count) const;
+    /**
+     * @brief Copies the part of the city network made of the given nodes (e.g. to answer a query about some of them).
+     * @param nodeIds The IDs of the nodes kept, each becoming the node with its index in nodeIds as ID.
+     * @return The city network with those nodes and the edges between them, fake ones included.
+     * @throws std::out_of_range If one of the nodes doesn't exist.
+     * @throws std::invalid_argument If a node is given more than once.
+     */
+    [[nodiscard]] CityNetwork subnetwork(const std::vector<int>& nodeIds) const;
+
+    /**
+     * @brief Gets the Held-Karp lower bound of the shortest tour (see OneTreeBound), over all the edges (fake ones
+     * included, like the heuristics).
+     * @return The lower bound (INFINITY if there is no tour).
+     *
+     * It is computed on the first call and kept until the data is reloaded. The time complexity is O(V^2) per
+     * subgradient iteration, with at most OneTreeBound::maxIterations iterations.
+     * */
+    double lowerBound() const;
+
+    /**
+     * @brief Gets how much longer a tour is than the lower bound, which bounds how far from optimal it is.
+     * @param path The tour.
+     * @return The gap, as a percentage of the lower bound (NAN if the tour isn't valid or there is no finite bound).
+     * */
+    double optimalityGap(const Path& path) const;
+
+    /**
+     * @brief Builds the edges forming a path of this network, from its first node back to itself.
+     * @param path The path.
+     * @return The edges forming the path, as the network keeps them (e.g. whether they are real).
      * */
-    Path greedyAlgorithm();
+    std::vector<Edge> getEdges(const Path& path) const;
 
     /**
      * @brief Overload the stream insertion operator to print a CityNetwork object.
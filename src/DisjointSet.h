@@ -0,0 +1,54 @@
+#ifndef CITYNETWORK_DISJOINTSET_H
+#define CITYNETWORK_DISJOINTSET_H
+
+#include <numeric>
+#include <utility>
+#include <vector>
+
+/**
+ * @class DisjointSet
+ * @brief Disjoint-set forest (union-find) with union by size and path halving.
+ *
+ * Both find() and unite() take amortized almost constant time.
+ */
+class DisjointSet {
+    std::vector<int> parent; /**< The parent of every element (itself if it is the representative). */
+    std::vector<int> setSize; /**< The size of every set, valid for representatives only. */
+public:
+    /**
+     * @brief Constructs the forest with every element in its own set.
+     * @param size The number of elements.
+     */
+    explicit DisjointSet(size_t size = 0) : parent(size), setSize(size, 1) {
+        std::iota(parent.begin(), parent.end(), 0);
+    }
+    /**
+     * @brief Gets the representative of the set of an element.
+     * @param element The element.
+     * @return The representative.
+     */
+    int find(int element) {
+        while (parent[element] != element) {
+            parent[element] = parent[parent[element]];
+            element = parent[element];
+        }
+        return element;
+    }
+    /**
+     * @brief Joins the sets of two elements.
+     * @param element1 The first element.
+     * @param element2 The second element.
+     * @return false if they were already in the same set, true otherwise.
+     */
+    bool unite(int element1, int element2) {
+        element1 = find(element1);
+        element2 = find(element2);
+        if (element1 == element2) return false;
+        if (setSize[element1] < setSize[element2]) std::swap(element1, element2);
+        parent[element2] = element1;
+        setSize[element1] += setSize[element2];
+        return true;
+    }
+};
+
+#endif //CITYNETWORK_DISJOINTSET_H
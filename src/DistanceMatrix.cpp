@@ -0,0 +1,68 @@
+#include "DistanceMatrix.h"
+
+using namespace std;
+
+DistanceMatrix::DistanceMatrix(unsigned int size) : nodeCount(0), dists(nullptr), pairs(0) {
+    resize(size);
+}
+
+DistanceMatrix::DistanceMatrix(const DistanceMatrix& other) :
+    nodeCount(other.nodeCount), ownedDists(other.ownedDists), pairs(other.pairs), mapping(other.mapping),
+    validEdges(other.validEdges), realEdges(other.realEdges) {
+    dists = mapping ? other.dists : ownedDists.data();
+}
+
+DistanceMatrix& DistanceMatrix::operator=(const DistanceMatrix& other) {
+    if (this != &other) {
+        DistanceMatrix copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+void DistanceMatrix::resize(unsigned int size) {
+    if (mapping) { // Copy the mapped distances before changing them.
+        ownedDists.assign(dists, dists + pairs);
+        mapping.reset();
+    }
+    pairs = (size_t) size * (size - (size > 0)) / 2;
+    nodeCount = size;
+    ownedDists.resize(pairs, INFINITY);
+    dists = ownedDists.data();
+    validEdges.resize(pairs);
+    realEdges.resize(pairs);
+}
+
+void DistanceMatrix::clear() {
+    nodeCount = 0;
+    pairs = 0;
+    ownedDists.clear();
+    ownedDists.shrink_to_fit();
+    dists = ownedDists.data();
+    mapping.reset();
+    validEdges = Bitset();
+    realEdges = Bitset();
+}
+
+void DistanceMatrix::set(int nodeId1, int nodeId2, double dist, bool real) {
+    if (mapping) resize(nodeCount);
+    size_t i = index(nodeId1, nodeId2);
+    ownedDists[i] = dist;
+    validEdges.set(i);
+    if (real) realEdges.set(i);
+    else realEdges.clear(i);
+}
+
+void DistanceMatrix::assignMapped(unsigned int size, const double* mappedDists, shared_ptr<const MappedFile> file, Bitset valid, Bitset real) {
+    clear();
+    nodeCount = size;
+    pairs = (size_t) size * (size - (size > 0)) / 2;
+    dists = mappedDists;
+    mapping = std::move(file);
+    validEdges = std::move(valid);
+    realEdges = std::move(real);
+}
+
+size_t DistanceMatrix::memoryUsage() const {
+    return ownedDists.capacity() * sizeof(double) + validEdges.memoryUsage() + realEdges.memoryUsage();
+}
@@ -0,0 +1,147 @@
+#ifndef CITYNETWORK_DISTANCEMATRIX_H
+#define CITYNETWORK_DISTANCEMATRIX_H
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Bitset.h"
+#include "MappedFile.h"
+
+/**
+ * @class DistanceMatrix
+ * @brief Dense storage of the distances between every unordered pair of nodes.
+ *
+ * Only the lower triangle of the matrix is kept, in one contiguous array, so every pair is stored once.
+ * The pair (i, j) with i > j lives at index i * (i - 1) / 2 + j, which means growing the matrix only appends to it.
+ * The real and valid flags of each pair are packed in separate bitsets.
+ * The distances may also be read straight from a memory-mapped snapshot, in which case they are only copied
+ * to memory if the matrix is modified.
+ */
+class DistanceMatrix {
+    unsigned int nodeCount; /**< The number of rows (and columns) of the matrix. */
+    std::vector<double> ownedDists; /**< The distances, when they are owned by the matrix. */
+    const double* dists; /**< The distance of every pair, INFINITY if the pair has no edge. */
+    size_t pairs; /**< The number of pairs stored. */
+    std::shared_ptr<const MappedFile> mapping; /**< The snapshot dists points into, if any. */
+    Bitset validEdges; /**< Bit set if the pair has an edge. */
+    Bitset realEdges; /**< Bit set if the edge of the pair was given by the user's file. */
+public:
+    /**
+     * @brief Constructs a matrix with the given number of nodes and no edges.
+     * @param size The number of nodes.
+     */
+    explicit DistanceMatrix(unsigned int size = 0);
+    DistanceMatrix(const DistanceMatrix& other);
+    DistanceMatrix(DistanceMatrix&& other) noexcept = default;
+    DistanceMatrix& operator=(const DistanceMatrix& other);
+    DistanceMatrix& operator=(DistanceMatrix&& other) noexcept = default;
+    /**
+     * @brief Resizes the matrix, keeping the edges between the nodes it already had.
+     * @param size The new number of nodes.
+     */
+    void resize(unsigned int size);
+    /**
+     * @brief Removes every node and edge from the matrix.
+     */
+    void clear();
+    /**
+     * @brief Gets the number of nodes of the matrix.
+     * @return The number of nodes.
+     */
+    [[nodiscard]] unsigned int size() const { return nodeCount; }
+    /**
+     * @brief Gets the number of unordered pairs stored by the matrix.
+     * @return The number of pairs.
+     */
+    [[nodiscard]] size_t pairCount() const { return pairs; }
+    /**
+     * @brief Gets the position of a pair in the triangular array.
+     * @param nodeId1 The ID of the first node.
+     * @param nodeId2 The ID of the second node (must be different from the first).
+     * @return The index of the pair.
+     */
+    [[nodiscard]] static size_t index(int nodeId1, int nodeId2) {
+        if (nodeId1 < nodeId2) std::swap(nodeId1, nodeId2);
+        return (size_t) nodeId1 * (nodeId1 - 1) / 2 + nodeId2;
+    }
+    /**
+     * @brief Sets the edge between two different nodes.
+     * @param nodeId1 The ID of the first node.
+     * @param nodeId2 The ID of the second node.
+     * @param dist The distance between the nodes.
+     * @param real Whether the edge was given by the user's file.
+     */
+    void set(int nodeId1, int nodeId2, double dist, bool real);
+    /**
+     * @brief Gets the distance between two different nodes.
+     * @param nodeId1 The ID of the first node.
+     * @param nodeId2 The ID of the second node.
+     * @return The distance, INFINITY if there is no edge.
+     */
+    [[nodiscard]] double getDist(int nodeId1, int nodeId2) const { return dists[index(nodeId1, nodeId2)]; }
+    /**
+     * @brief Checks if there is an edge between two different nodes.
+     * @param nodeId1 The ID of the first node.
+     * @param nodeId2 The ID of the second node.
+     * @return true if the edge exists, false otherwise.
+     */
+    [[nodiscard]] bool isValid(int nodeId1, int nodeId2) const { return validEdges.test(index(nodeId1, nodeId2)); }
+    /**
+     * @brief Checks if the edge between two different nodes was given by the user's file.
+     * @param nodeId1 The ID of the first node.
+     * @param nodeId2 The ID of the second node.
+     * @return true if the edge is real, false otherwise.
+     */
+    [[nodiscard]] bool isReal(int nodeId1, int nodeId2) const { return realEdges.test(index(nodeId1, nodeId2)); }
+    /**
+     * @brief Gets the distance stored at a position of the triangular array.
+     * @param pairIndex The index of the pair, as given by index().
+     * @return The distance, INFINITY if there is no edge.
+     */
+    [[nodiscard]] double getDistAt(size_t pairIndex) const { return dists[pairIndex]; }
+    /**
+     * @brief Checks if the pair at a position of the triangular array has an edge.
+     * @param pairIndex The index of the pair, as given by index().
+     * @return true if the edge exists, false otherwise.
+     */
+    [[nodiscard]] bool isValidAt(size_t pairIndex) const { return validEdges.test(pairIndex); }
+    /**
+     * @brief Checks if the pair at a position of the triangular array has an edge given by the user's file.
+     * @param pairIndex The index of the pair, as given by index().
+     * @return true if the edge is real, false otherwise.
+     */
+    [[nodiscard]] bool isRealAt(size_t pairIndex) const { return realEdges.test(pairIndex); }
+    /**
+     * @brief Gets the distances of every pair, in triangular order.
+     * @return Pointer to the pairCount() distances.
+     */
+    [[nodiscard]] const double* getDists() const { return dists; }
+    /**
+     * @brief Gets the valid flag of every pair.
+     * @return The bitset of valid pairs.
+     */
+    [[nodiscard]] const Bitset& getValidEdges() const { return validEdges; }
+    /**
+     * @brief Gets the real flag of every pair.
+     * @return The bitset of real pairs.
+     */
+    [[nodiscard]] const Bitset& getRealEdges() const { return realEdges; }
+    /**
+     * @brief Replaces the contents of the matrix with distances that live in a mapped file.
+     * @param size The number of nodes.
+     * @param mappedDists The size * (size - 1) / 2 distances, in triangular order.
+     * @param file The mapped file the distances belong to (kept open while the matrix uses it).
+     * @param valid The valid flag of every pair.
+     * @param real The real flag of every pair.
+     */
+    void assignMapped(unsigned int size, const double* mappedDists, std::shared_ptr<const MappedFile> file, Bitset valid, Bitset real);
+    /**
+     * @brief Gets the memory used by the matrix, in bytes (mapped distances not included).
+     * @return The memory used.
+     */
+    [[nodiscard]] size_t memoryUsage() const;
+};
+
+#endif //CITYNETWORK_DISTANCEMATRIX_H
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "GreedyMatching.h"
+
+using namespace std;
+
+namespace {
+    /**
+     * @brief Maps a double to an unsigned integer with the same order (negative values have every bit flipped, the
+     * others only the sign bit).
+     */
+    inline uint64_t sortKey(double value) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return (bits & (1ULL << 63)) ? ~bits : bits | (1ULL << 63);
+    }
+
+    /**
+     * @brief Stable LSD radix sort by distance, 16 bits per pass. The histograms of every pass are counted in one read
+     * of the edges, and passes where every key has the same digit are skipped.
+     */
+    void radixSort(vector<GreedyMatching::CandidateEdge>& edges) {
+        const int digitBits = 16, passes = 64 / digitBits;
+        const size_t buckets = size_t(1) << digitBits;
+        vector<size_t> counts(passes * buckets);
+        for (const GreedyMatching::CandidateEdge& edge : edges) {
+            const uint64_t key = sortKey(edge.dist);
+            for (int pass = 0; pass < passes; pass++) counts[pass * buckets + ((key >> (pass * digitBits)) & (buckets - 1))]++;
+        }
+        vector<GreedyMatching::CandidateEdge> buffer(edges.size());
+        const uint64_t firstKey = sortKey(edges[0].dist);
+        for (int pass = 0; pass < passes; pass++) {
+            const int shift = pass * digitBits;
+            size_t* passCounts = &counts[pass * buckets];
+            if (passCounts[(firstKey >> shift) & (buckets - 1)] == edges.size()) continue;
+            size_t offset = 0;
+            for (size_t bucket = 0; bucket < buckets; bucket++) {
+                const size_t bucketSize = passCounts[bucket];
+                passCounts[bucket] = offset;
+                offset += bucketSize;
+            }
+            for (const GreedyMatching::CandidateEdge& edge : edges)
+                buffer[passCounts[(sortKey(edge.dist) >> shift) & (buckets - 1)]++] = edge;
+            edges.swap(buffer);
+        }
+    }
+}
+
+GreedyMatching::GreedyMatching(size_t size, unsigned int nodeCount) :
+    neighbours(2 * size, -1), fragments(size), nodeCount(nodeCount), finished(0) {}
+
+void GreedyMatching::sortEdges(vector<CandidateEdge>& edges, bool radix) {
+    if (edges.empty()) return;
+    if (radix) {
+        radixSort(edges);
+        return;
+    }
+    stable_sort(edges.begin(), edges.end(), [](const CandidateEdge& edge1, const CandidateEdge& edge2) {
+        return edge1.dist < edge2.dist;
+    });
+}
+
+bool GreedyMatching::tryAdd(const CandidateEdge& edge) {
+    if (nodeCount < 3) return false; // No tour: nothing to match.
+    const int originDegree = getDegree(edge.origin);
+    const int destDegree = getDegree(edge.dest);
+    if (originDegree == 2 || destDegree == 2) return false;
+    if (!fragments.unite(edge.origin, edge.dest)) {
+        // Both are the ends of the same fragment: only the last edge may close the cycle.
+        if (finished != nodeCount - 2) return false;
+    }
+    neighbours[2 * edge.origin + originDegree] = edge.dest;
+    neighbours[2 * edge.dest + destDegree] = edge.origin;
+    finished += (originDegree == 1) + (destDegree == 1);
+    return true;
+}
+
+void GreedyMatching::addEdges(const vector<CandidateEdge>& sortedEdges) {
+    for (const CandidateEdge& edge : sortedEdges) {
+        if (isComplete()) break;
+        tryAdd(edge);
+    }
+}
+
+vector<int> GreedyMatching::getTour(int startId) const {
+    vector<int> order;
+    if (!isComplete()) return order;
+    order.reserve(nodeCount);
+    int prevId = startId;
+    int currId = min(neighbours[2 * startId], neighbours[2 * startId + 1]);
+    order.push_back(startId);
+    while (currId != startId) {
+        order.push_back(currId);
+        int nextId = neighbours[2 * currId] == prevId ? neighbours[2 * currId + 1] : neighbours[2 * currId];
+        prevId = currId;
+        currId = nextId;
+    }
+    return order;
+}
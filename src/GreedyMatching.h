@@ -0,0 +1,91 @@
+#ifndef CITYNETWORK_GREEDYMATCHING_H
+#define CITYNETWORK_GREEDYMATCHING_H
+
+#include <vector>
+#include "DisjointSet.h"
+
+/**
+ * @class GreedyMatching
+ * @brief Builds a tour by taking edges from shortest to longest, as long as they keep every node's degree at most 2
+ * and don't close a cycle before every node is in it.
+ *
+ * Fragments (paths built so far) are tracked with a disjoint-set forest, so checking and merging them is almost O(1).
+ * The candidate edges are kept in a compact array sorted once, instead of a priority queue of full Edge objects.
+ */
+class GreedyMatching {
+public:
+    /**
+     * @struct CandidateEdge
+     * @brief A compact edge offered to the matching.
+     */
+    struct CandidateEdge {
+        double dist; /**< The distance between the nodes. */
+        int origin; /**< The ID of one node. */
+        int dest; /**< The ID of the other node. */
+    };
+
+private:
+    std::vector<int> neighbours; /**< The (up to) two neighbours of every node, -1 if none. */
+    DisjointSet fragments; /**< The fragment every node belongs to. */
+    unsigned int nodeCount; /**< The number of nodes the tour must visit. */
+    unsigned int finished; /**< The number of nodes with degree 2. */
+
+public:
+    /**
+     * @brief Constructs an empty matching.
+     * @param size The number of node IDs (the highest ID plus one).
+     * @param nodeCount The number of nodes the tour must visit.
+     */
+    GreedyMatching(size_t size, unsigned int nodeCount);
+
+    /**
+     * @brief Sorts edges by distance, keeping the order of edges with the same distance.
+     * @param edges The edges to sort.
+     * @param radix Whether to use an LSD radix sort on the bits of the distances (stable, O(E)) instead of std::stable_sort.
+     */
+    static void sortEdges(std::vector<CandidateEdge>& edges, bool radix);
+
+    /**
+     * @brief Offers an edge to the matching.
+     * @param edge The edge.
+     * @return true if the edge was added to the tour, false if it was rejected.
+     */
+    bool tryAdd(const CandidateEdge& edge);
+
+    /**
+     * @brief Offers sorted edges to the matching, in order, until the tour is complete.
+     * @param sortedEdges The edges, sorted by distance.
+     */
+    void addEdges(const std::vector<CandidateEdge>& sortedEdges);
+
+    /**
+     * @brief Checks if the edges added so far form a tour through every node.
+     * @return true if the tour is complete, false otherwise (always for fewer than 3 nodes, which have no tour).
+     */
+    [[nodiscard]] bool isComplete() const { return nodeCount >= 3 && finished == nodeCount; }
+
+    /**
+     * @brief Gets the number of edges of the tour attached to a node.
+     * @param nodeId The ID of the node.
+     * @return The degree of the node (0, 1 or 2).
+     */
+    [[nodiscard]] int getDegree(int nodeId) const { return (neighbours[2 * nodeId] >= 0) + (neighbours[2 * nodeId + 1] >= 0); }
+
+    /**
+     * @brief Checks if two nodes are in the same fragment.
+     * @param nodeId1 The ID of the first node.
+     * @param nodeId2 The ID of the second node.
+     * @return true if they are, false otherwise.
+     */
+    [[nodiscard]] bool sameFragment(int nodeId1, int nodeId2) { return fragments.find(nodeId1) == fragments.find(nodeId2); }
+
+    /**
+     * @brief Gets the order the complete tour visits the nodes in, starting at the given node and going first to its
+     * neighbour with the lowest ID.
+     * @param startId The ID of the first node.
+     * @return The visiting order (empty if the tour isn't complete).
+     */
+    [[nodiscard]] std::vector<int> getTour(int startId) const;
+};
+
+#endif //CITYNETWORK_GREEDYMATCHING_H
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cmath>
+
+#include "HaversineKernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CITYNETWORK_HAVE_AVX2
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+    // Rational approximations of asin, from Cephes (asin.c).
+    const double P[] = {4.253011369004428248960E-3, -6.019598008014123785661E-1, 5.444622390564711410273E0,
+                        -1.626247967210700244449E1, 1.956261983317594739197E1, -8.198089802484824371615E0};
+    const double Q[] = {-1.474091372988853791896E1, 7.049610280856842141659E1, -1.471791292232726029859E2,
+                        1.395105614657485689735E2, -4.918853881490881290097E1};
+    const double R[] = {2.967721961301243206100E-3, -5.634242780008963776856E-1, 6.968710824104713396794E0,
+                        -2.556901049652824852289E1, 2.853665548261061424989E1};
+    const double S[] = {-2.194779531642920639778E1, 1.470656354026814941758E2, -3.838770957603691357202E2,
+                        3.424398657913078477438E2};
+    const double pio4 = 7.85398163397448309616E-1;
+    const double moreBits = 6.123233995736765886130E-17;
+    const double asinSplit = 0.625;
+
+    /**
+     * @brief asin(x) for x in [0, 1].
+     */
+    inline double asinPositive(double x) {
+        if (x > asinSplit) {
+            double zz = 1.0 - x;
+            double num = ((((R[0] * zz + R[1]) * zz + R[2]) * zz + R[3]) * zz + R[4]);
+            double den = ((((zz + S[0]) * zz + S[1]) * zz + S[2]) * zz + S[3]);
+            double p = zz * num / den;
+            zz = sqrt(zz + zz);
+            double z = pio4 - zz;
+            zz = zz * p - moreBits;
+            z = z - zz;
+            return z + pio4;
+        }
+        double zz = x * x;
+        double num = (((((P[0] * zz + P[1]) * zz + P[2]) * zz + P[3]) * zz + P[4]) * zz + P[5]);
+        double den = (((((zz + Q[0]) * zz + Q[1]) * zz + Q[2]) * zz + Q[3]) * zz + Q[4]);
+        double z = zz * num / den;
+        return x * z + x;
+    }
+
+    /**
+     * @brief The haversine distance given the terms of both nodes.
+     */
+    inline double haversine(double sinHalfLat1, double cosHalfLat1, double sinHalfLon1, double cosHalfLon1, double cosLat1,
+                            double sinHalfLat2, double cosHalfLat2, double sinHalfLon2, double cosHalfLon2, double cosLat2) {
+        const double sinLat = sinHalfLat2 * cosHalfLat1 - cosHalfLat2 * sinHalfLat1; // sin(deltaLat / 2)
+        const double sinLon = sinHalfLon2 * cosHalfLon1 - cosHalfLon2 * sinHalfLon1; // sin(deltaLon / 2)
+        double aux = sinLat * sinLat + (cosLat1 * cosLat2) * (sinLon * sinLon);
+        aux = min(aux, 1.0);
+        return HaversineKernel::earthRadius * (2.0 * asinPositive(sqrt(aux)));
+    }
+
+#ifdef CITYNETWORK_HAVE_AVX2
+    __attribute__((target("avx2")))
+    inline __m256d polynomial(__m256d x, const double* coefs, int count) {
+        __m256d result = _mm256_set1_pd(coefs[0]);
+        for (int i = 1; i < count; i++) result = _mm256_add_pd(_mm256_mul_pd(result, x), _mm256_set1_pd(coefs[i]));
+        return result;
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256d monicPolynomial(__m256d x, const double* coefs, int count) {
+        __m256d result = _mm256_add_pd(x, _mm256_set1_pd(coefs[0]));
+        for (int i = 1; i < count; i++) result = _mm256_add_pd(_mm256_mul_pd(result, x), _mm256_set1_pd(coefs[i]));
+        return result;
+    }
+
+    /**
+     * @brief asinPositive() on four values: both branches are evaluated and blended.
+     */
+    __attribute__((target("avx2")))
+    inline __m256d asinPositive4(__m256d x) {
+        // x > 0.625
+        __m256d zz = _mm256_sub_pd(_mm256_set1_pd(1.0), x);
+        __m256d p = _mm256_div_pd(_mm256_mul_pd(zz, polynomial(zz, R, 5)), monicPolynomial(zz, S, 4));
+        zz = _mm256_sqrt_pd(_mm256_add_pd(zz, zz));
+        __m256d z = _mm256_sub_pd(_mm256_set1_pd(pio4), zz);
+        zz = _mm256_sub_pd(_mm256_mul_pd(zz, p), _mm256_set1_pd(moreBits));
+        z = _mm256_sub_pd(z, zz);
+        __m256d large = _mm256_add_pd(z, _mm256_set1_pd(pio4));
+        // x <= 0.625
+        zz = _mm256_mul_pd(x, x);
+        z = _mm256_div_pd(_mm256_mul_pd(zz, polynomial(zz, P, 6)), monicPolynomial(zz, Q, 5));
+        __m256d small = _mm256_add_pd(_mm256_mul_pd(x, z), x);
+        return _mm256_blendv_pd(small, large, _mm256_cmp_pd(x, _mm256_set1_pd(asinSplit), _CMP_GT_OQ));
+    }
+
+    __attribute__((target("avx2")))
+    void haversineAvx2(const double* terms1, const double* sinHalfLat, const double* cosHalfLat, const double* sinHalfLon,
+                       const double* cosHalfLon, const double* cosLat, size_t count, double* out) {
+        const __m256d sinHalfLat1 = _mm256_set1_pd(terms1[0]);
+        const __m256d cosHalfLat1 = _mm256_set1_pd(terms1[1]);
+        const __m256d sinHalfLon1 = _mm256_set1_pd(terms1[2]);
+        const __m256d cosHalfLon1 = _mm256_set1_pd(terms1[3]);
+        const __m256d cosLat1 = _mm256_set1_pd(terms1[4]);
+        const __m256d one = _mm256_set1_pd(1.0);
+        const __m256d two = _mm256_set1_pd(2.0);
+        const __m256d radius = _mm256_set1_pd(HaversineKernel::earthRadius);
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256d sinLat = _mm256_sub_pd(_mm256_mul_pd(_mm256_loadu_pd(sinHalfLat + i), cosHalfLat1),
+                                           _mm256_mul_pd(_mm256_loadu_pd(cosHalfLat + i), sinHalfLat1));
+            __m256d sinLon = _mm256_sub_pd(_mm256_mul_pd(_mm256_loadu_pd(sinHalfLon + i), cosHalfLon1),
+                                           _mm256_mul_pd(_mm256_loadu_pd(cosHalfLon + i), sinHalfLon1));
+            __m256d aux = _mm256_add_pd(_mm256_mul_pd(sinLat, sinLat),
+                                        _mm256_mul_pd(_mm256_mul_pd(cosLat1, _mm256_loadu_pd(cosLat + i)), _mm256_mul_pd(sinLon, sinLon)));
+            aux = _mm256_min_pd(aux, one);
+            __m256d result = _mm256_mul_pd(radius, _mm256_mul_pd(two, asinPositive4(_mm256_sqrt_pd(aux))));
+            _mm256_storeu_pd(out + i, result);
+        }
+        for (; i < count; i++) {
+            out[i] = haversine(terms1[0], terms1[1], terms1[2], terms1[3], terms1[4],
+                               sinHalfLat[i], cosHalfLat[i], sinHalfLon[i], cosHalfLon[i], cosLat[i]);
+        }
+    }
+
+    bool cpuHasAvx2() {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+    }
+#endif
+}
+
+void HaversineKernel::assign(const vector<double>& lats, const vector<double>& lons) {
+    clear();
+    size_t count = min(lats.size(), lons.size());
+    sinHalfLat.resize(count);
+    cosHalfLat.resize(count);
+    sinHalfLon.resize(count);
+    cosHalfLon.resize(count);
+    cosLat.resize(count);
+    invalid.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        if (!isfinite(lats[i]) || !isfinite(lons[i])) {
+            invalid.set(i);
+            hasInvalid = true;
+            continue; // Leaves zeros, the result is replaced by INFINITY.
+        }
+        const double radLat = lats[i] * M_PI / 180;
+        const double radLon = lons[i] * M_PI / 180;
+        sinHalfLat[i] = sin(radLat / 2);
+        cosHalfLat[i] = cos(radLat / 2);
+        sinHalfLon[i] = sin(radLon / 2);
+        cosHalfLon[i] = cos(radLon / 2);
+        cosLat[i] = cos(radLat);
+    }
+}
+
+void HaversineKernel::clear() {
+    sinHalfLat.clear();
+    cosHalfLat.clear();
+    sinHalfLon.clear();
+    cosHalfLon.clear();
+    cosLat.clear();
+    invalid = Bitset();
+    hasInvalid = false;
+}
+
+double HaversineKernel::distance(int nodeId1, int nodeId2) const {
+    if (hasInvalid && (invalid.test(nodeId1) || invalid.test(nodeId2))) return INFINITY;
+    return haversine(sinHalfLat[nodeId1], cosHalfLat[nodeId1], sinHalfLon[nodeId1], cosHalfLon[nodeId1], cosLat[nodeId1],
+                     sinHalfLat[nodeId2], cosHalfLat[nodeId2], sinHalfLon[nodeId2], cosHalfLon[nodeId2], cosLat[nodeId2]);
+}
+
+void HaversineKernel::distancesScalar(int from, int begin, int end, double* out) const {
+    for (int i = begin; i < end; i++) {
+        out[i - begin] = haversine(sinHalfLat[from], cosHalfLat[from], sinHalfLon[from], cosHalfLon[from], cosLat[from],
+                                   sinHalfLat[i], cosHalfLat[i], sinHalfLon[i], cosHalfLon[i], cosLat[i]);
+    }
+    if (hasInvalid) {
+        for (int i = begin; i < end; i++)
+            if (invalid.test(from) || invalid.test(i)) out[i - begin] = INFINITY;
+    }
+}
+
+void HaversineKernel::distances(int from, int begin, int end, double* out) const {
+#ifdef CITYNETWORK_HAVE_AVX2
+    if (begin < end && cpuHasAvx2()) {
+        const double terms1[] = {sinHalfLat[from], cosHalfLat[from], sinHalfLon[from], cosHalfLon[from], cosLat[from]};
+        haversineAvx2(terms1, &sinHalfLat[begin], &cosHalfLat[begin], &sinHalfLon[begin], &cosHalfLon[begin],
+                      &cosLat[begin], end - begin, out);
+        if (hasInvalid) {
+            for (int i = begin; i < end; i++)
+                if (invalid.test(from) || invalid.test(i)) out[i - begin] = INFINITY;
+        }
+        return;
+    }
+#endif
+    distancesScalar(from, begin, end, out);
+}
+
+const char* HaversineKernel::getInstructionSet() {
+#ifdef CITYNETWORK_HAVE_AVX2
+    if (cpuHasAvx2()) return "AVX2";
+#endif
+    return "scalar";
+}
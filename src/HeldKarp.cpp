@@ -0,0 +1,88 @@
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+#include "HeldKarp.h"
+
+using namespace std;
+
+size_t HeldKarp::memoryUsage(int nodeCount) {
+    if (nodeCount < 2) return 0;
+    const size_t entries = ((size_t) 1 << (nodeCount - 1)) * (nodeCount - 1);
+    return entries * (sizeof(double) + sizeof(uint8_t));
+}
+
+vector<int> HeldKarp::solve(const vector<double>& dist, int nodeCount, unsigned int threadCount) {
+    if (nodeCount < 2 || nodeCount > maxNodes) return {};
+    // The subsets are of the nodes 1 to nodeCount - 1, where node i is bit i - 1.
+    const int m = nodeCount - 1;
+    const uint32_t full = ((uint32_t) 1 << m) - 1;
+    vector<double> cost(((size_t) full + 1) * m, INFINITY);
+    vector<uint8_t> pred(((size_t) full + 1) * m, 0);
+    for (int j = 0; j < m; j++) cost[((size_t) 1 << j) * m + j] = dist[j + 1];
+    // The distances into every node j from the nodes i, contiguous in i for the inner loop.
+    vector<double> distTo((size_t) m * m);
+    for (int j = 0; j < m; j++)
+        for (int i = 0; i < m; i++) distTo[(size_t) j * m + i] = dist[(size_t) (i + 1) * nodeCount + j + 1];
+
+    // Solves the subsets with layer nodes among the blocks of subsets first, first + stride, ...
+    constexpr uint32_t blockSize = 4096;
+    auto solveLayer = [&](int layer, uint32_t first, uint32_t stride) {
+        for (uint32_t block = first * blockSize; block <= full; block += stride * blockSize) {
+            const uint32_t end = min(full, block + blockSize - 1);
+            for (uint32_t mask = block; mask <= end; mask++) {
+                if (__builtin_popcount(mask) != layer) continue;
+                double* row = &cost[(size_t) mask * m];
+                uint8_t* predRow = &pred[(size_t) mask * m];
+                for (uint32_t js = mask; js; js &= js - 1) {
+                    const int j = __builtin_ctz(js);
+                    const uint32_t prevMask = mask ^ ((uint32_t) 1 << j);
+                    const double* prevRow = &cost[(size_t) prevMask * m];
+                    const double* distToJ = &distTo[(size_t) j * m];
+                    double best = INFINITY;
+                    int bestI = 0;
+                    // The lowest predecessor wins ties.
+                    for (uint32_t is = prevMask; is; is &= is - 1) {
+                        const int i = __builtin_ctz(is);
+                        const double candidate = prevRow[i] + distToJ[i];
+                        if (candidate < best) {
+                            best = candidate;
+                            bestI = i;
+                        }
+                    }
+                    row[j] = best;
+                    predRow[j] = (uint8_t) bestI;
+                }
+            }
+        }
+    };
+    const unsigned int workers = max(1u, min(threadCount, (full >> 12) + 1));
+    for (int layer = 2; layer <= m; layer++) {
+        vector<thread> threads;
+        for (unsigned int t = 1; t < workers; t++) threads.emplace_back(solveLayer, layer, t, workers);
+        solveLayer(layer, 0, workers);
+        for (thread &t : threads) t.join();
+    }
+
+    // Close the cycle and follow the predecessors back to node 0.
+    double best = INFINITY;
+    int last = -1;
+    for (int j = 0; j < m; j++) {
+        const double candidate = cost[(size_t) full * m + j] + dist[(size_t) (j + 1) * nodeCount];
+        if (candidate < best) {
+            best = candidate;
+            last = j;
+        }
+    }
+    if (last < 0) return {};
+    vector<int> order(nodeCount);
+    uint32_t mask = full;
+    for (int pos = m; pos >= 1; pos--) {
+        order[pos] = last + 1;
+        const int prev = pred[(size_t) mask * m + last];
+        mask ^= (uint32_t) 1 << last;
+        last = prev;
+    }
+    order[0] = 0;
+    return order;
+}
@@ -0,0 +1,41 @@
+#ifndef CITYNETWORK_HELDKARP_H
+#define CITYNETWORK_HELDKARP_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class HeldKarp
+ * @brief Exact shortest tours by the Held-Karp dynamic programming over subsets.
+ *
+ * Node 0 is the start. For every subset S of the other nodes and every node j in S, cost[S][j] is the length of the
+ * shortest path that starts at node 0, visits exactly the nodes of S and ends at j, and pred[S][j] is the node before
+ * j on it. Both are flat arrays indexed by S * (n - 1) + j. A subset only depends on the subsets with one node less,
+ * so the subsets with the same number of nodes (one popcount layer) are split among the threads. Takes O(2^n * n^2)
+ * time and O(2^n * n) memory (9 bytes per entry).
+ */
+class HeldKarp {
+public:
+    static constexpr int maxNodes = 25; /**< The largest number of nodes solved (about 3.6 GB). */
+
+    /**
+     * @brief Gets the memory the solver needs for a number of nodes.
+     * @param nodeCount The number of nodes.
+     * @return The size of the cost and predecessor arrays, in bytes.
+     */
+    static size_t memoryUsage(int nodeCount);
+
+    /**
+     * @brief Finds the shortest tour that starts and ends at node 0.
+     *
+     * Path lengths add the edges from node 0 onwards, like CityNetwork::Path does, so the length of the tour found is
+     * exactly the smallest such sum.
+     * @param dist The distance from node i to node j at i * nodeCount + j (INFINITY if there is no edge).
+     * @param nodeCount The number of nodes (at most maxNodes).
+     * @param threadCount The number of threads to use.
+     * @return The nodes in visiting order, starting at 0, or an empty vector if there is no tour.
+     */
+    static std::vector<int> solve(const std::vector<double>& dist, int nodeCount, unsigned int threadCount);
+};
+
+#endif //CITYNETWORK_HELDKARP_H
@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "HilbertCurve.h"
+
+using namespace std;
+
+uint64_t HilbertCurve::index(uint32_t x, uint32_t y) {
+    uint64_t result = 0;
+    for (uint32_t side = 1u << (order - 1); side > 0; side >>= 1) {
+        const uint32_t right = (x & side) ? 1 : 0;
+        const uint32_t top = (y & side) ? 1 : 0;
+        result += (uint64_t) side * side * ((3 * right) ^ top);
+        // Rotate the quadrant so the curve inside it starts and ends in the right corners.
+        if (top == 0) {
+            if (right == 1) {
+                x = side - 1 - (x & (side - 1));
+                y = side - 1 - (y & (side - 1));
+            }
+            swap(x, y);
+        }
+    }
+    return result;
+}
+
+vector<int> HilbertCurve::sort(const vector<double>& lats, const vector<double>& lons) {
+    const size_t count = min(lats.size(), lons.size());
+    double minLat = INFINITY, maxLat = -INFINITY, minLon = INFINITY, maxLon = -INFINITY;
+    for (size_t i = 0; i < count; i++) {
+        if (!isfinite(lats[i]) || !isfinite(lons[i])) continue;
+        minLat = min(minLat, lats[i]);
+        maxLat = max(maxLat, lats[i]);
+        minLon = min(minLon, lons[i]);
+        maxLon = max(maxLon, lons[i]);
+    }
+    if (minLat > maxLat) return {};
+    const double lonScale = cos((minLat + maxLat) / 2 * M_PI / 180);
+    const double side = max({(maxLat - minLat), (maxLon - minLon) * lonScale, 1e-12});
+    const double cells = (double) ((1u << order) - 1);
+    vector<pair<uint64_t, int>> keys;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        if (!isfinite(lats[i]) || !isfinite(lons[i])) continue;
+        const auto x = (uint32_t) ((lons[i] - minLon) * lonScale / side * cells);
+        const auto y = (uint32_t) ((lats[i] - minLat) / side * cells);
+        keys.emplace_back(index(x, y), (int) i);
+    }
+    std::sort(keys.begin(), keys.end());
+    vector<int> ids(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) ids[i] = keys[i].second;
+    return ids;
+}
@@ -0,0 +1,38 @@
+#ifndef CITYNETWORK_HILBERTCURVE_H
+#define CITYNETWORK_HILBERTCURVE_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class HilbertCurve
+ * @brief Orders the nodes of a coordinate dataset along a Hilbert curve.
+ *
+ * The coordinates are projected onto a plane (the longitudes scaled by the cosine of the middle latitude, so both axes
+ * have about the same length per degree), the bounding square is divided into a 2^order by 2^order grid and every
+ * node gets the position of its cell along the curve. The curve visits every cell of a quadrant before moving to the
+ * next one, at every scale, so nodes close on the curve are close on the map, and visiting them in curve order gives
+ * a tour 10-20% longer than the nearest neighbor one. Sorting by position takes O(V log V) time, with no distances.
+ */
+class HilbertCurve {
+public:
+    static constexpr int order = 16; /**< The number of levels of the curve (2^order cells per side). */
+
+    /**
+     * @brief Gets the position of a cell along the curve.
+     * @param x The column of the cell (less than 2^order).
+     * @param y The row of the cell (less than 2^order).
+     * @return The number of cells before it on the curve.
+     */
+    static uint64_t index(uint32_t x, uint32_t y);
+
+    /**
+     * @brief Sorts the nodes along the curve (node i has latitude lats[i] and longitude lons[i], in degrees).
+     * @param lats The latitudes.
+     * @param lons The longitudes.
+     * @return The IDs of the nodes with coordinates (those without, INFINITY, are left out), in curve order, ties by ID.
+     */
+    static std::vector<int> sort(const std::vector<double>& lats, const std::vector<double>& lons);
+};
+
+#endif //CITYNETWORK_HILBERTCURVE_H
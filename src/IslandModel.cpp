@@ -0,0 +1,80 @@
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include "IslandModel.h"
+#include "Tour.h"
+
+using namespace std;
+
+IslandModel::IslandModel(LocalSearch::DistanceFunction dist, const CandidateSet& candidates, size_t idCount) :
+    dist(std::move(dist)), candidates(candidates), idCount(idCount) {}
+
+IslandModel::Result IslandModel::run(const vector<vector<int>>& starts, double seconds) const {
+    const auto start = chrono::steady_clock::now();
+    auto elapsed = [&start]() { return chrono::duration<double>(chrono::steady_clock::now() - start).count(); };
+    atomic<const SharedTour*> slot(nullptr);
+    atomic<unsigned long long> kicks(0), adoptions(0);
+    // The tours every island published, freed at the end.
+    vector<vector<unique_ptr<SharedTour>>> published(starts.size());
+
+    auto island = [&](size_t index) {
+        IteratedLocalSearch search(dist, candidates);
+        Tour tour(starts[index], idCount);
+        search.optimize(tour);
+        double bestLength = search.length(tour);
+        mt19937 generator((unsigned int) index + 1);
+        unsigned long long islandKicks = 0;
+        double nextExchange = exchangeInterval;
+        while (elapsed() < seconds) {
+            bestLength -= search.kick(tour, generator);
+            islandKicks++;
+            if (elapsed() < nextExchange) continue;
+            nextExchange = elapsed() + exchangeInterval;
+            bestLength = search.length(tour); // Drop the drift of the running total before comparing.
+            // Publish the best tour if it is shorter than the shared one.
+            const SharedTour* shared = slot.load(memory_order_acquire);
+            if (shared == nullptr || bestLength < shared->length - LocalSearch::epsilon) {
+                auto copy = make_unique<SharedTour>(SharedTour{bestLength, tour.getOrder(tour.at(0))});
+                while (shared == nullptr || bestLength < shared->length - LocalSearch::epsilon) {
+                    if (slot.compare_exchange_weak(shared, copy.get(), memory_order_acq_rel, memory_order_acquire)) {
+                        published[index].push_back(std::move(copy));
+                        break;
+                    }
+                }
+            } else if (shared->length < bestLength - LocalSearch::epsilon) {
+                // Take the shared tour.
+                tour = Tour(shared->order, idCount);
+                bestLength = shared->length;
+                adoptions++;
+            }
+        }
+        kicks += islandKicks;
+        // The island's own best tour, in case it is shorter than the shared one.
+        bestLength = search.length(tour);
+        const SharedTour* shared = slot.load(memory_order_acquire);
+        auto copy = make_unique<SharedTour>(SharedTour{bestLength, tour.getOrder(tour.at(0))});
+        while (shared == nullptr || bestLength < shared->length) {
+            if (slot.compare_exchange_weak(shared, copy.get(), memory_order_acq_rel, memory_order_acquire)) {
+                published[index].push_back(std::move(copy));
+                break;
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (size_t i = 1; i < starts.size(); i++) threads.emplace_back(island, i);
+    if (!starts.empty()) island(0);
+    for (thread &t : threads) t.join();
+
+    Result result;
+    const SharedTour* shared = slot.load(memory_order_acquire);
+    if (shared != nullptr) {
+        result.order = shared->order;
+        result.length = shared->length;
+    }
+    result.kicks = kicks;
+    result.adoptions = adoptions;
+    result.seconds = elapsed();
+    return result;
+}
@@ -0,0 +1,70 @@
+#ifndef CITYNETWORK_ISLANDMODEL_H
+#define CITYNETWORK_ISLANDMODEL_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "CandidateSet.h"
+#include "IteratedLocalSearch.h"
+#include "LocalSearch.h"
+
+/**
+ * @class IslandModel
+ * @brief Runs several iterated local searches (islands) at once, one per thread, each from its own start tour, and
+ * lets them share their best tours.
+ *
+ * Every exchangeInterval seconds an island publishes its best tour if it is shorter than the shared one, and takes
+ * the shared one if it is shorter than its own. The shared tour is a single lock-free slot: an atomic pointer to an
+ * immutable copy of the tour and its length, replaced with compare-and-swap only by shorter tours. So the published
+ * lengths only go down and every island reads a whole tour without waiting for the others. A published copy is freed
+ * when the search ends (the slot is only replaced when the best tour improves, so there are few of them).
+ */
+class IslandModel {
+public:
+    static constexpr double exchangeInterval = 0.5; /**< The time between two exchanges of an island, in seconds. */
+
+    /**
+     * @struct Result
+     * @brief The best tour found and the work done.
+     */
+    struct Result {
+        std::vector<int> order; /**< The best tour, in visiting order. */
+        double length = INFINITY; /**< The length of the best tour. */
+        unsigned long long kicks = 0; /**< The number of tours evaluated (kicks followed by local search), in total. */
+        unsigned long long adoptions = 0; /**< The number of times an island took the shared tour. */
+        double seconds = 0; /**< The time spent, in seconds. */
+    };
+
+private:
+    /**
+     * @struct SharedTour
+     * @brief A published tour, never changed after being published.
+     */
+    struct SharedTour {
+        double length; /**< The length of the tour. */
+        std::vector<int> order; /**< The tour, in visiting order. */
+    };
+
+    LocalSearch::DistanceFunction dist; /**< The distances between the nodes (called by every thread at once). */
+    const CandidateSet& candidates; /**< The candidates of every node. */
+    size_t idCount; /**< The number of node IDs (the highest ID plus one). */
+
+public:
+    /**
+     * @brief Constructs the island model.
+     * @param dist The distances between the nodes, safe to call from several threads at once.
+     * @param candidates The candidates of every node.
+     * @param idCount The number of node IDs (the highest ID plus one).
+     */
+    IslandModel(LocalSearch::DistanceFunction dist, const CandidateSet& candidates, size_t idCount);
+
+    /**
+     * @brief Runs one island per start tour, each on its own thread, until the time runs out.
+     * @param starts The start tour of every island, in visiting order.
+     * @param seconds The time budget, in seconds.
+     * @return The best tour found by any island.
+     */
+    [[nodiscard]] Result run(const std::vector<std::vector<int>>& starts, double seconds) const;
+};
+
+#endif //CITYNETWORK_ISLANDMODEL_H
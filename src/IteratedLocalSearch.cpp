@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <chrono>
+
+#include "IteratedLocalSearch.h"
+
+using namespace std;
+
+IteratedLocalSearch::IteratedLocalSearch(LocalSearch::DistanceFunction dist, const CandidateSet& candidates) :
+    dist(dist), search(dist, candidates) {}
+
+double IteratedLocalSearch::length(const Tour& tour) const {
+    double total = 0;
+    for (int pos = 0; pos < tour.size(); pos++) total += dist(tour.at(pos), tour.at(pos + 1 == tour.size() ? 0 : pos + 1));
+    return total;
+}
+
+double IteratedLocalSearch::kick(Tour& tour, mt19937& generator) const {
+    // A double bridge needs two segments plus a node on each side.
+    const int size = tour.size();
+    const int maxSegment = min(segmentLength, (size - 2) / 2);
+    if (maxSegment < 1) return 0;
+    // The segments B = b1..b2 and C = c1..c2 between a1 and d1.
+    const int pos = uniform_int_distribution<int>(0, size - 1)(generator);
+    uniform_int_distribution<int> segmentDistribution(1, maxSegment);
+    const int lengthB = segmentDistribution(generator), lengthC = segmentDistribution(generator);
+    const int a1 = tour.at(pos);
+    const int b1 = tour.next(a1), b2 = tour.at((pos + lengthB) % size);
+    const int c1 = tour.next(b2), c2 = tour.at((pos + lengthB + lengthC) % size);
+    const int d1 = tour.next(c2);
+    const double kickGain = dist(a1, b1) + dist(b2, c1) + dist(c2, d1) - dist(a1, c1) - dist(c2, b1) - dist(b2, d1);
+    tour.checkpoint();
+    // A C B D as three 2-opt moves: a1 c2..c1 b2..b1 d1, then a1 c1..c2 b2..b1 d1, then a1 c1..c2 b1..b2 d1.
+    tour.twoOptMove(a1, b1, c2, d1);
+    tour.twoOptMove(a1, c2, c1, b2);
+    tour.twoOptMove(c2, b2, b1, d1);
+    const double gain = kickGain + search.run(tour, {a1, b1, b2, c1, c2, d1});
+    if (gain <= -LocalSearch::epsilon) {
+        tour.rollback();
+        return 0;
+    }
+    // Equal tours are kept too, so the search can drift along plateaus.
+    return gain > LocalSearch::epsilon ? gain : 0;
+}
+
+unsigned long long IteratedLocalSearch::run(Tour& tour, double seconds, const ProgressFunction& progress, unsigned int seed) const {
+    const auto start = chrono::steady_clock::now();
+    auto elapsed = [&start]() { return chrono::duration<double>(chrono::steady_clock::now() - start).count(); };
+    optimize(tour);
+    double bestLength = length(tour);
+    unsigned long long iterations = 0, improvements = 0;
+    double lastReport = 0;
+    bool improved = false;
+    auto report = [&]() {
+        lastReport = elapsed();
+        improved = false;
+        return !progress || progress({lastReport, bestLength, iterations, improvements, tour});
+    };
+    mt19937 generator(seed);
+    while (tour.size() >= 4 && elapsed() < seconds) {
+        const double gain = kick(tour, generator);
+        iterations++;
+        if (gain > 0) {
+            bestLength -= gain;
+            improvements++;
+            improved = true;
+        }
+        if (improved && elapsed() - lastReport >= reportInterval && !report()) break;
+    }
+    // The running total drifts a little, so the final length is summed again.
+    bestLength = length(tour);
+    report();
+    return iterations;
+}
@@ -0,0 +1,87 @@
+#ifndef CITYNETWORK_ITERATEDLOCALSEARCH_H
+#define CITYNETWORK_ITERATEDLOCALSEARCH_H
+
+#include <functional>
+#include <random>
+#include "CandidateSet.h"
+#include "LinKernighan.h"
+#include "LocalSearch.h"
+#include "Tour.h"
+
+/**
+ * @class IteratedLocalSearch
+ * @brief Keeps improving a tour until a deadline: Lin-Kernighan, then random double bridge kicks, each followed by
+ * Lin-Kernighan again, keeping the kicked tour only if it is no longer than the best one.
+ *
+ * A double bridge cuts the tour into A B C D and reconnects it as A C B D, which no sequence of improving 2-opt or
+ * LK moves undoes. B and C are short (at most segmentLength nodes) and consecutive, so the kick is local and the
+ * local search only starts from its 6 end nodes (the rest of the tour is still locally optimal). A rejected kick is
+ * undone by rolling back the moves it made (see Tour::rollback()), so the tour is always the best one and is never
+ * copied.
+ */
+class IteratedLocalSearch {
+public:
+    static constexpr int segmentLength = 50; /**< The maximum number of nodes of each segment moved by a kick. */
+    static constexpr double reportInterval = 0.25; /**< The minimum time between two progress reports, in seconds. */
+
+    /**
+     * @struct Progress
+     * @brief The state of the search, given to the progress function.
+     */
+    struct Progress {
+        double elapsed; /**< The time since the search started, in seconds. */
+        double bestLength; /**< The length of the best tour found so far. */
+        unsigned long long iterations; /**< The number of kicks made. */
+        unsigned long long improvements; /**< The number of kicks that gave a shorter tour. */
+        const Tour& best; /**< The best tour found so far. */
+    };
+    typedef std::function<bool(const Progress&)> ProgressFunction; /**< Called with the progress, returns false to stop. */
+
+private:
+    LocalSearch::DistanceFunction dist; /**< The distances between the nodes. */
+    LinKernighan search; /**< The local search run after every kick. */
+
+public:
+    /**
+     * @brief Constructs the search.
+     * @param dist The distances between the nodes.
+     * @param candidates The candidates of every node.
+     */
+    IteratedLocalSearch(LocalSearch::DistanceFunction dist, const CandidateSet& candidates);
+
+    /**
+     * @brief Gets the length of a tour.
+     * @param tour The tour.
+     * @return The sum of its edges.
+     */
+    [[nodiscard]] double length(const Tour& tour) const;
+
+    /**
+     * @brief Improves a tour with Lin-Kernighan until no move shortens it (what run() does first).
+     * @param tour The tour.
+     * @return The gain.
+     */
+    double optimize(Tour& tour) const { return search.run(tour); }
+
+    /**
+     * @brief Makes one iteration: a random double bridge kick on the tour and Lin-Kernighan from its ends. The result
+     * is kept if it is no longer than the tour was, else its moves are rolled back.
+     * @param tour The tour, locally optimal (its journal is restarted, see Tour::checkpoint()).
+     * @param generator The random generator of the kicks.
+     * @return How much shorter the kept tour is (0 if it is as long or was rejected).
+     */
+    double kick(Tour& tour, std::mt19937& generator) const;
+
+    /**
+     * @brief Improves the tour until the time runs out or the progress function stops it.
+     * @param tour The tour, replaced by the best one found.
+     * @param seconds The time budget, in seconds.
+     * @param progress Called when a shorter tour was found (at most every reportInterval seconds) and at the end, may
+     * be empty.
+     * @param seed The seed of the random kicks.
+     * @return The number of kicks made.
+     */
+    unsigned long long run(Tour& tour, double seconds, const ProgressFunction& progress = nullptr, unsigned int seed = 1) const;
+};
+
+#endif //CITYNETWORK_ITERATEDLOCALSEARCH_H
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cmath>
+
+#include "KdTree.h"
+
+using namespace std;
+
+void KdTree::assign(const vector<double>& lats, const vector<double>& lons) {
+    clear();
+    const size_t count = min(lats.size(), lons.size());
+    positions.assign(count, -1);
+    for (size_t i = 0; i < count; i++) {
+        if (!isfinite(lats[i]) || !isfinite(lons[i])) continue;
+        const double radLat = lats[i] * M_PI / 180;
+        const double radLon = lons[i] * M_PI / 180;
+        points.push_back({{cos(radLat) * cos(radLon), cos(radLat) * sin(radLon), sin(radLat)}, (int) i});
+    }
+    axes.resize(points.size());
+    counts.resize(points.size());
+    build(0, (int) points.size());
+    for (int pos = 0; pos < (int) points.size(); pos++) positions[points[pos].id] = pos;
+}
+
+int KdTree::build(int lo, int hi) {
+    if (lo >= hi) return 0;
+    double low[3] = {INFINITY, INFINITY, INFINITY}, high[3] = {-INFINITY, -INFINITY, -INFINITY};
+    for (int i = lo; i < hi; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            low[axis] = min(low[axis], points[i].coords[axis]);
+            high[axis] = max(high[axis], points[i].coords[axis]);
+        }
+    }
+    int axis = 0;
+    for (int other = 1; other < 3; other++)
+        if (high[other] - low[other] > high[axis] - low[axis]) axis = other;
+    const int mid = lo + (hi - lo) / 2;
+    nth_element(points.begin() + lo, points.begin() + mid, points.begin() + hi, [axis](const Point& point1, const Point& point2) {
+        return point1.coords[axis] < point2.coords[axis];
+    });
+    axes[mid] = axis;
+    counts[mid] = 1 + build(lo, mid) + build(mid + 1, hi);
+    return counts[mid];
+}
+
+void KdTree::clear() {
+    points.clear();
+    axes.clear();
+    counts.clear();
+    positions.clear();
+}
+
+bool KdTree::contains(int nodeId, const Removals& removals) const {
+    if (nodeId < 0 || nodeId >= (int) positions.size() || positions[nodeId] < 0) return false;
+    return !removals.removed.test(positions[nodeId]);
+}
+
+void KdTree::restore(Removals& removals) const {
+    removals.alive = counts;
+    removals.removed.resize(points.size());
+    removals.removed.reset();
+}
+
+void KdTree::remove(int nodeId, Removals& removals) const {
+    if (!contains(nodeId, removals)) return;
+    const int pos = positions[nodeId];
+    removals.removed.set(pos);
+    // Every subtree on the way from the root to the point loses one node.
+    int lo = 0, hi = (int) points.size();
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        removals.alive[mid]--;
+        if (pos == mid) break;
+        if (pos < mid) hi = mid;
+        else lo = mid + 1;
+    }
+}
+
+void KdTree::nearest(int lo, int hi, const double* target, int excludedId, const Removals& removals, int& bestId, double& bestDist) const {
+    if (lo >= hi) return;
+    const int mid = lo + (hi - lo) / 2;
+    if (removals.alive[mid] == 0) return;
+    const Point& point = points[mid];
+    if (!removals.removed.test(mid) && point.id != excludedId) {
+        double dist = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            const double diff = point.coords[axis] - target[axis];
+            dist += diff * diff;
+        }
+        if (dist < bestDist || (dist == bestDist && point.id < bestId)) {
+            bestDist = dist;
+            bestId = point.id;
+        }
+    }
+    const double diff = target[axes[mid]] - point.coords[axes[mid]];
+    // Search the side of the target first, then the other side if it may hold a point as near (ties included).
+    if (diff < 0) {
+        nearest(lo, mid, target, excludedId, removals, bestId, bestDist);
+        if (diff * diff <= bestDist) nearest(mid + 1, hi, target, excludedId, removals, bestId, bestDist);
+    } else {
+        nearest(mid + 1, hi, target, excludedId, removals, bestId, bestDist);
+        if (diff * diff <= bestDist) nearest(lo, mid, target, excludedId, removals, bestId, bestDist);
+    }
+}
+
+int KdTree::nearest(int nodeId, const Removals& removals) const {
+    if (nodeId < 0 || nodeId >= (int) positions.size() || positions[nodeId] < 0) return -1;
+    int bestId = -1;
+    double bestDist = INFINITY;
+    nearest(0, (int) points.size(), points[positions[nodeId]].coords, nodeId, removals, bestId, bestDist);
+    return bestId;
+}
+
+void KdTree::nearest(int lo, int hi, const double* target, int excludedId, size_t k, vector<pair<double, int>>& best) const {
+    if (lo >= hi) return;
+    const int mid = lo + (hi - lo) / 2;
+    const Point& point = points[mid];
+    if (point.id != excludedId) {
+        double dist = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            const double diff = point.coords[axis] - target[axis];
+            dist += diff * diff;
+        }
+        const pair<double, int> candidate(dist, point.id);
+        if (best.size() < k) {
+            best.push_back(candidate);
+            push_heap(best.begin(), best.end());
+        } else if (candidate < best.front()) {
+            pop_heap(best.begin(), best.end());
+            best.back() = candidate;
+            push_heap(best.begin(), best.end());
+        }
+    }
+    const double diff = target[axes[mid]] - point.coords[axes[mid]];
+    const auto farthest = [&]() { return best.size() < k ? INFINITY : best.front().first; };
+    if (diff < 0) {
+        nearest(lo, mid, target, excludedId, k, best);
+        if (diff * diff <= farthest()) nearest(mid + 1, hi, target, excludedId, k, best);
+    } else {
+        nearest(mid + 1, hi, target, excludedId, k, best);
+        if (diff * diff <= farthest()) nearest(lo, mid, target, excludedId, k, best);
+    }
+}
+
+vector<int> KdTree::nearest(int nodeId, int k) const {
+    if (nodeId < 0 || nodeId >= (int) positions.size() || positions[nodeId] < 0 || k <= 0) return {};
+    vector<pair<double, int>> best;
+    best.reserve(k);
+    nearest(0, (int) points.size(), points[positions[nodeId]].coords, nodeId, k, best);
+    sort_heap(best.begin(), best.end());
+    vector<int> ids;
+    for (const auto& [dist, id] : best) ids.push_back(id);
+    return ids;
+}
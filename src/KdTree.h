@@ -0,0 +1,113 @@
+#ifndef CITYNETWORK_KDTREE_H
+#define CITYNETWORK_KDTREE_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Bitset.h"
+
+/**
+ * @class KdTree
+ * @brief A k-d tree over the nodes of a coordinate dataset, for nearest neighbour queries with deletion.
+ *
+ * Every node is mapped to its point on the unit sphere (x, y, z). The straight-line (chord) distance between two such
+ * points grows with the great-circle distance, so the nearest node by chord is also the nearest by haversine, without
+ * any trigonometry in the queries. The tree is stored implicitly: the subtree of the range [lo, hi) of the point
+ * array has its root at the middle, split along the axis where the range is widest. The tree itself never changes
+ * after it is built: nodes are removed from a Removals set kept by the caller, so any number of searches can remove
+ * nodes from the same tree at once. Removed nodes stay in the tree but every subtree counts its remaining nodes, so
+ * empty subtrees are skipped and queries stay O(log V) on average even after most nodes were removed.
+ */
+class KdTree {
+public:
+    /**
+     * @struct Removals
+     * @brief The nodes removed from a tree by one search.
+     */
+    struct Removals {
+        std::vector<int> alive; /**< The number of nodes not removed in the subtree rooted at each position. */
+        Bitset removed; /**< The removed points, by position. */
+    };
+
+private:
+    /**
+     * @struct Point
+     * @brief A node on the unit sphere.
+     */
+    struct Point {
+        double coords[3]; /**< The x, y and z coordinates. */
+        int id; /**< The ID of the node. */
+    };
+    std::vector<Point> points; /**< The points, in tree order. */
+    std::vector<unsigned char> axes; /**< The split axis of the subtree rooted at each position. */
+    std::vector<int> counts; /**< The number of nodes in the subtree rooted at each position. */
+    std::vector<int> positions; /**< The position of every node ID in points (-1 if it isn't in the tree). */
+
+    /**
+     * @brief Builds the subtree of a range of points, returning its number of points.
+     */
+    int build(int lo, int hi);
+    /**
+     * @brief Searches a subtree for a point nearer than the best so far, other than the excluded node and the removed
+     * ones.
+     */
+    void nearest(int lo, int hi, const double* target, int excludedId, const Removals& removals, int& bestId, double& bestDist) const;
+    /**
+     * @brief Searches a subtree for the points nearer than the farthest of the best k so far, kept as a max-heap of
+     * (squared chord distance, ID).
+     */
+    void nearest(int lo, int hi, const double* target, int excludedId, size_t k, std::vector<std::pair<double, int>>& best) const;
+public:
+    /**
+     * @brief Builds the tree (node i has latitude lats[i] and longitude lons[i], in degrees).
+     *
+     * Nodes without coordinates (INFINITY) are left out. Takes O(V log V) time.
+     * @param lats The latitudes.
+     * @param lons The longitudes.
+     */
+    void assign(const std::vector<double>& lats, const std::vector<double>& lons);
+    /**
+     * @brief Removes every node from the tree.
+     */
+    void clear();
+    /**
+     * @brief Gets the number of nodes of the tree.
+     * @return The number of nodes.
+     */
+    [[nodiscard]] size_t size() const { return points.size(); }
+    /**
+     * @brief Checks if a node is in the tree and wasn't removed.
+     * @param nodeId The ID of the node.
+     * @param removals The nodes removed.
+     * @return true if it is, false otherwise.
+     */
+    [[nodiscard]] bool contains(int nodeId, const Removals& removals) const;
+    /**
+     * @brief Puts back every node in a set of removals (sizing it for the tree), in O(V) time.
+     * @param removals The nodes removed.
+     */
+    void restore(Removals& removals) const;
+    /**
+     * @brief Removes a node from the results of the queries made with a set of removals, in O(log V) time.
+     * @param nodeId The ID of the node.
+     * @param removals The nodes removed, restored for this tree.
+     */
+    void remove(int nodeId, Removals& removals) const;
+    /**
+     * @brief Finds the node nearest to a node (which may itself be in the tree) that wasn't removed.
+     * @param nodeId The ID of the node to search from.
+     * @param removals The nodes removed, restored for this tree.
+     * @return The ID of the nearest node other than nodeId, the lowest ID on ties, -1 if there is none.
+     */
+    [[nodiscard]] int nearest(int nodeId, const Removals& removals) const;
+    /**
+     * @brief Finds the k nodes nearest to a node, in O(k log V) time on average.
+     * @param nodeId The ID of the node to search from.
+     * @param k The number of nodes to find.
+     * @return The IDs of the nearest nodes other than nodeId (fewer if the tree has fewer), nearest first, the lowest
+     * IDs first on ties.
+     */
+    [[nodiscard]] std::vector<int> nearest(int nodeId, int k) const;
+};
+
+#endif //CITYNETWORK_KDTREE_H
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <deque>
+#include <tuple>
+
+#include "LinKernighan.h"
+
+using namespace std;
+
+LinKernighan::LinKernighan(LocalSearch::DistanceFunction dist, const CandidateSet& candidates) :
+    dist(std::move(dist)), candidates(candidates) {}
+
+void LinKernighan::move(Tour& tour, Chain& chain, int a, int b, int c, int d) {
+    tour.twoOptMove(a, b, c, d);
+    chain.moves.push_back({a, b, c, d});
+}
+
+void LinKernighan::undo(Tour& tour, Chain& chain, size_t length) {
+    while (chain.moves.size() > length) {
+        const auto [a, b, c, d] = chain.moves.back();
+        tour.twoOptMove(a, c, b, d); // Removes (a, c) and (b, d), adds (a, b) and (c, d) back.
+        chain.moves.pop_back();
+    }
+}
+
+void LinKernighan::close(Chain& chain, int t4, double gain) const {
+    const double closeGain = gain - dist(t4, chain.t1);
+    if (closeGain > chain.bestGain) {
+        chain.bestGain = closeGain;
+        chain.bestLength = (int) chain.moves.size();
+    }
+}
+
+void LinKernighan::step(Tour& tour, Chain& chain, int level, int t2, double gain) const {
+    if (level >= maxDepth) return;
+    const int t1 = chain.t1;
+    const bool forward = tour.next(t1) == t2;
+    // The possible next steps, as (score, t3, t4), best first.
+    vector<tuple<double, int, int>> steps;
+    const int* neighbours = candidates.getNeighbours(t2);
+    const double* neighbourDists = candidates.getDists(t2);
+    for (int i = 0; i < candidates.getCount(t2); i++) {
+        if (gain - neighbourDists[i] <= LocalSearch::epsilon) break; // The gain must stay positive.
+        const int t3 = neighbours[i];
+        if (t3 == t1 || t3 == tour.next(t2) || t3 == tour.prev(t2)) continue;
+        const int t4 = forward ? tour.prev(t3) : tour.next(t3);
+        if (find(chain.added.begin(), chain.added.end(), make_pair(min(t3, t4), max(t3, t4))) == chain.added.end())
+            steps.emplace_back(dist(t3, t4) - neighbourDists[i], t3, t4);
+        if (level > 0) continue;
+        const int otherT4 = forward ? tour.next(t3) : tour.prev(t3);
+        if (otherT4 != t1) steps.emplace_back(dist(t3, otherT4) - neighbourDists[i], t3, otherT4);
+    }
+    sort(steps.begin(), steps.end(), [](const tuple<double, int, int>& step1, const tuple<double, int, int>& step2) {
+        return get<0>(step1) > get<0>(step2);
+    });
+    const int tries = min((int) steps.size(), level < (int) size(breadth) ? breadth[level] : 1);
+    for (int i = 0; i < tries; i++) {
+        const auto [score, t3, t4] = steps[i];
+        if (t4 != (forward ? tour.prev(t3) : tour.next(t3))) {
+            if (alternateStep(tour, chain, t2, t3, t4, gain)) return;
+            continue;
+        }
+        move(tour, chain, t1, t2, t4, t3); // Removes (t1, t2) and (t4, t3), adds (t1, t4) and (t2, t3).
+        chain.added.emplace_back(min(t2, t3), max(t2, t3));
+        const double newGain = gain - dist(t2, t3) + dist(t3, t4);
+        close(chain, t4, newGain);
+        step(tour, chain, level + 1, t4, newGain);
+        if (chain.bestGain > LocalSearch::epsilon) return; // Improved: the caller cuts the chain at the best length.
+        undo(tour, chain, chain.moves.size() - 1);
+        chain.added.pop_back();
+    }
+}
+
+bool LinKernighan::alternateStep(Tour& tour, Chain& chain, int t2, int t3, int t4, double gain) const {
+    const int t1 = chain.t1;
+    const bool forward = tour.next(t1) == t2;
+    // Removing (t1, t2) and (t3, t4) and adding (t2, t3) closes the path from t2 to t3 into a cycle of its own. The
+    // join removes one of its edges (t5, t6) and adds (t4, t5), so the path from t6 to t5 goes between t1 and t4.
+    const double splitGain = gain - dist(t2, t3) + dist(t3, t4);
+    vector<tuple<double, int, int>> joins;
+    const int* neighbours = candidates.getNeighbours(t4);
+    const double* neighbourDists = candidates.getDists(t4);
+    for (int i = 0; i < candidates.getCount(t4); i++) {
+        if (splitGain - neighbourDists[i] <= LocalSearch::epsilon) break;
+        const int t5 = neighbours[i];
+        if (t5 == t3 || !(forward ? tour.between(t2, t5, t3) : tour.between(t3, t5, t2))) continue;
+        const int after = forward ? tour.next(t5) : tour.prev(t5), before = forward ? tour.prev(t5) : tour.next(t5);
+        joins.emplace_back(dist(t5, after) - neighbourDists[i], t5, after);
+        if (t5 != t2) joins.emplace_back(dist(t5, before) - neighbourDists[i], t5, before);
+    }
+    sort(joins.begin(), joins.end(), [](const tuple<double, int, int>& join1, const tuple<double, int, int>& join2) {
+        return get<0>(join1) > get<0>(join2);
+    });
+    const int tries = min((int) joins.size(), breadth[1]);
+    for (int i = 0; i < tries; i++) {
+        const auto [score, t5, t6] = joins[i];
+        const size_t length = chain.moves.size();
+        if (t6 == (forward ? tour.next(t5) : tour.prev(t5))) {
+            // t1 [t2..t5] [t6..t3] t4 -> t1 [t6..t3] [t2..t5] t4, by reversing the whole path then both parts.
+            move(tour, chain, t1, t2, t3, t4);
+            move(tour, chain, t1, t3, t6, t5);
+            move(tour, chain, t3, t5, t2, t4);
+        } else {
+            // t1 [t2..t6] [t5..t3] t4 -> t1 [t6..t2] [t3..t5] t4, by reversing both parts.
+            move(tour, chain, t1, t2, t6, t5);
+            move(tour, chain, t2, t5, t3, t4);
+        }
+        chain.added.emplace_back(min(t2, t3), max(t2, t3));
+        chain.added.emplace_back(min(t4, t5), max(t4, t5));
+        const double newGain = splitGain - dist(t4, t5) + dist(t5, t6);
+        close(chain, t6, newGain);
+        step(tour, chain, 2, t6, newGain);
+        if (chain.bestGain > LocalSearch::epsilon) return true;
+        undo(tour, chain, length);
+        chain.added.resize(chain.added.size() - 2);
+    }
+    return false;
+}
+
+double LinKernighan::run(Tour& tour) const {
+    vector<int> nodeIds;
+    for (int pos = 0; pos < tour.size(); pos++) nodeIds.push_back(tour.at(pos));
+    return run(tour, nodeIds);
+}
+
+double LinKernighan::run(Tour& tour, const vector<int>& nodeIds) const {
+    if (tour.size() < 5) return 0;
+    // The nodes to look at (the others have their don't-look bit set).
+    deque<int> queue;
+    vector<bool> queued(candidates.size(), false);
+    for (int nodeId : nodeIds) {
+        if (queued[nodeId]) continue;
+        queue.push_back(nodeId);
+        queued[nodeId] = true;
+    }
+    auto push = [&](int nodeId) {
+        if (queued[nodeId]) return;
+        queued[nodeId] = true;
+        queue.push_back(nodeId);
+    };
+    double totalGain = 0;
+    Chain chain;
+    while (!queue.empty()) {
+        const int t1 = queue.front();
+        queue.pop_front();
+        queued[t1] = false;
+        for (int t2 : {tour.next(t1), tour.prev(t1)}) {
+            chain.t1 = t1;
+            chain.moves.clear();
+            chain.added.clear();
+            chain.bestGain = 0;
+            chain.bestLength = 0;
+            step(tour, chain, 0, t2, dist(t1, t2));
+            if (chain.bestGain <= LocalSearch::epsilon) continue;
+            // Undo the moves after the best closing.
+            undo(tour, chain, chain.bestLength);
+            for (const auto& [a, b, c, d] : chain.moves) {
+                push(a);
+                push(b);
+                push(c);
+                push(d);
+            }
+            totalGain += chain.bestGain;
+            break;
+        }
+    }
+    return totalGain;
+}
@@ -0,0 +1,97 @@
+#ifndef CITYNETWORK_LINKERNIGHAN_H
+#define CITYNETWORK_LINKERNIGHAN_H
+
+#include <array>
+#include <utility>
+#include <vector>
+#include "CandidateSet.h"
+#include "LocalSearch.h"
+#include "Tour.h"
+
+/**
+ * @class LinKernighan
+ * @brief Improves a tour with Lin-Kernighan style variable-depth moves until none of them shortens it.
+ *
+ * A move starts by removing a tour edge (t1, t2) and grows a chain: t2 gets a new edge to a candidate t3, and the
+ * edge (t3, t4) that keeps the tour a cycle is removed, so t4 takes the place of t2. Every step is a 2-opt move on
+ * the tour, and the chain goes on while the sum of the removed edges minus the added ones stays positive, up to
+ * maxDepth steps. The move is cut back to the step where closing the cycle (adding (t4, t1)) gave the largest gain.
+ * The first levels try several candidates (breadth) and backtrack, deeper levels only the most promising one. An
+ * edge added by the chain is never removed again in the same move. Don't-look bits are kept like in LocalSearch.
+ *
+ * The first step may also remove the edge on the other side of t3 (see alternateStep()): that splits the tour in two
+ * cycles, which the second step joins back by removing an edge (t5, t6) of the one through t2 and t3 and adding
+ * (t4, t5). This gives the 3-opt moves (e.g. moving a segment elsewhere) that a chain of 2-opt moves can't reach.
+ *
+ * The tour is an array with a position index (Tour), which reverses the shorter side of each flip.
+ */
+class LinKernighan {
+public:
+    static constexpr int maxDepth = 50; /**< The maximum number of steps of a move. */
+    static constexpr int breadth[] = {5, 3}; /**< The number of candidates tried at the first levels (1 deeper). */
+
+private:
+    LocalSearch::DistanceFunction dist; /**< The distances between the nodes. */
+    const CandidateSet& candidates; /**< The candidates of every node. */
+
+    /**
+     * @struct Chain
+     * @brief The state of the move being built from one base node.
+     */
+    struct Chain {
+        int t1; /**< The base node. */
+        std::vector<std::array<int, 4>> moves; /**< The 2-opt moves made, as (a, b, c, d), to undo them. */
+        std::vector<std::pair<int, int>> added; /**< The edges added by the chain. */
+        double bestGain; /**< The largest gain found by closing the cycle. */
+        int bestLength; /**< The number of moves of the best closing. */
+    };
+
+    /**
+     * @brief Makes a 2-opt move on the tour and records it in the chain (see Tour::twoOptMove()).
+     */
+    static void move(Tour& tour, Chain& chain, int a, int b, int c, int d);
+    /**
+     * @brief Undoes the last moves of the chain, last first, until it has the given number of moves.
+     */
+    static void undo(Tour& tour, Chain& chain, size_t length);
+    /**
+     * @brief Records the gain of closing the cycle from t4 (with gain so far) if it is the best one.
+     */
+    void close(Chain& chain, int t4, double gain) const;
+    /**
+     * @brief Extends the chain from t2 (with (t1, t2) removed and gain so far) at a level, searching depth first.
+     */
+    void step(Tour& tour, Chain& chain, int level, int t2, double gain) const;
+    /**
+     * @brief Makes the first step with t4 on the other side of t3, then the second one that joins the two cycles, and
+     * goes on from t6.
+     * @return true if the chain improved the tour, false otherwise (then the tour is as it was).
+     */
+    bool alternateStep(Tour& tour, Chain& chain, int t2, int t3, int t4, double gain) const;
+
+public:
+    /**
+     * @brief Constructs the local search.
+     * @param dist The distances between the nodes.
+     * @param candidates The candidates of every node.
+     */
+    LinKernighan(LocalSearch::DistanceFunction dist, const CandidateSet& candidates);
+
+    /**
+     * @brief Improves the tour until no move shortens it.
+     * @param tour The tour.
+     * @return The total gain.
+     */
+    double run(Tour& tour) const;
+
+    /**
+     * @brief Improves the tour until no move shortens it, starting from the given nodes only (the others have their
+     * don't-look bits set until a move changes them), e.g. around a change of an otherwise locally optimal tour.
+     * @param tour The tour.
+     * @param nodeIds The IDs of the nodes to start from.
+     * @return The total gain.
+     */
+    double run(Tour& tour, const std::vector<int>& nodeIds) const;
+};
+
+#endif //CITYNETWORK_LINKERNIGHAN_H
@@ -0,0 +1,200 @@
+#include <deque>
+#include <utility>
+
+#include "LocalSearch.h"
+
+using namespace std;
+
+namespace {
+    /**
+     * @brief Moves the path s1..s2 (p s1 ... s2 n, forward) between c and d (c d, forward, outside the path and d != p).
+     * The result is p n ... c s1 ... s2 d, or c s2 ... s1 d if reversed. Made of three (or two) 2-opt moves.
+     */
+    void moveSegment(Tour& tour, int p, int s1, int s2, int n, int c, int d, bool reversed) {
+        tour.twoOptMove(p, s1, c, d); // p c ... n s2 ... s1 d
+        tour.twoOptMove(p, c, n, s2); // p n ... c s2 ... s1 d
+        if (!reversed) tour.twoOptMove(c, s2, s1, d); // p n ... c s1 ... s2 d
+    }
+
+    /**
+     * @brief Keeps a move in improvement if it gains more than the one there.
+     */
+    bool offer(LocalSearch::Improvement& improvement, double gain, std::initializer_list<int> nodes, int variant) {
+        if (!(gain > improvement.gain)) return false;
+        improvement.gain = gain;
+        improvement.nodeCount = 0;
+        for (int nodeId : nodes) improvement.nodes[improvement.nodeCount++] = nodeId;
+        improvement.variant = variant;
+        return true;
+    }
+}
+
+LocalSearch::LocalSearch(DistanceFunction dist, const CandidateSet& candidates, Policy policy) :
+    distFunction(std::move(dist)), candidates(candidates), policy(policy) {}
+
+void LocalSearch::addMove(unique_ptr<Move> move) {
+    moves.push_back(std::move(move));
+    moveCounts.push_back(0);
+}
+
+double LocalSearch::run(Tour& tour) {
+    moveCounts.assign(moves.size(), 0);
+    if (tour.size() < 5 || moves.empty()) return 0;
+    // The nodes to look at (the others have their don't-look bit set).
+    deque<int> queue;
+    vector<bool> queued(candidates.size(), false);
+    for (int pos = 0; pos < tour.size(); pos++) {
+        queue.push_back(tour.at(pos));
+        queued[tour.at(pos)] = true;
+    }
+    auto push = [&](int nodeId) {
+        if (queued[nodeId]) return;
+        queued[nodeId] = true;
+        queue.push_back(nodeId);
+    };
+    double totalGain = 0;
+    while (!queue.empty()) {
+        const int nodeId = queue.front();
+        queue.pop_front();
+        queued[nodeId] = false;
+        Improvement improvement;
+        improvement.gain = epsilon;
+        for (int i = 0; i < (int) moves.size(); i++) {
+            if (moves[i]->search(*this, tour, nodeId, improvement)) {
+                improvement.moveIndex = i;
+                if (policy == firstImprovement) break;
+            }
+        }
+        if (improvement.moveIndex < 0) continue;
+        moves[improvement.moveIndex]->apply(tour, improvement);
+        moveCounts[improvement.moveIndex]++;
+        totalGain += improvement.gain;
+        for (int i = 0; i < improvement.nodeCount; i++) push(improvement.nodes[i]);
+        push(nodeId);
+    }
+    return totalGain;
+}
+
+bool TwoOptMove::search(const LocalSearch& engine, const Tour& tour, int a, LocalSearch::Improvement& improvement) const {
+    const CandidateSet& candidates = engine.getCandidates();
+    bool found = false;
+    for (int forward = 1; forward >= 0; forward--) {
+        // Remove (a, b) and (c, d), add (a, c) and (b, d), where b and d follow a and c in the same direction.
+        const int b = forward ? tour.next(a) : tour.prev(a);
+        const double distAB = engine.dist(a, b);
+        const int* neighbours = candidates.getNeighbours(a);
+        const double* neighbourDists = candidates.getDists(a);
+        for (int i = 0; i < candidates.getCount(a); i++) {
+            const double distAC = neighbourDists[i];
+            if (distAC >= distAB) break; // The gain can't be positive.
+            const int c = neighbours[i];
+            const int d = forward ? tour.next(c) : tour.prev(c);
+            if (c == b || d == a) continue;
+            const double gain = distAB + engine.dist(c, d) - distAC - engine.dist(b, d);
+            if (offer(improvement, gain, {a, b, c, d}, 0)) {
+                found = true;
+                if (engine.isFirstImprovement()) return true;
+            }
+        }
+    }
+    return found;
+}
+
+void TwoOptMove::apply(Tour& tour, const LocalSearch::Improvement& improvement) const {
+    const int* nodes = improvement.nodes;
+    tour.twoOptMove(nodes[0], nodes[1], nodes[2], nodes[3]);
+}
+
+bool OrOptMove::search(const LocalSearch& engine, const Tour& tour, int a, LocalSearch::Improvement& improvement) const {
+    const CandidateSet& candidates = engine.getCandidates();
+    bool found = false;
+    for (int length = 1; length <= maxLength && length + 3 <= tour.size(); length++) {
+        for (int startsAtA = 1; startsAtA >= (length == 1 ? 1 : 0); startsAtA--) {
+            // The path p s1 ... s2 n (forward), with a = s1 or a = s2.
+            int s1 = a, s2 = a;
+            for (int i = 1; i < length; i++) {
+                if (startsAtA) s2 = tour.next(s2);
+                else s1 = tour.prev(s1);
+            }
+            const int p = tour.prev(s1), n = tour.next(s2);
+            const double removeGain = engine.dist(p, s1) + engine.dist(s2, n) - engine.dist(p, n);
+            const int other = startsAtA ? s2 : s1; // The other end of the path.
+            const int* neighbours = candidates.getNeighbours(a);
+            const double* neighbourDists = candidates.getDists(a);
+            for (int i = 0; i < candidates.getCount(a); i++) {
+                const double distAC = neighbourDists[i];
+                if (distAC >= removeGain) break; // The gain can't be positive.
+                const int c = neighbours[i];
+                if (tour.between(s1, c, s2)) continue;
+                // Insert between c and its successor, a next to c.
+                const int next = tour.next(c);
+                if (next != s1 && next != p) {
+                    const double gain = removeGain - (distAC + engine.dist(other, next) - engine.dist(c, next));
+                    if (offer(improvement, gain, {p, s1, s2, n, c, next}, startsAtA ? 0 : 1)) {
+                        found = true;
+                        if (engine.isFirstImprovement()) return true;
+                    }
+                }
+                // Insert between c's predecessor and c, a next to c.
+                const int prev = tour.prev(c);
+                if (prev != s2 && c != p) {
+                    const double gain = removeGain - (distAC + engine.dist(prev, other) - engine.dist(prev, c));
+                    if (offer(improvement, gain, {p, s1, s2, n, prev, c}, startsAtA ? 1 : 0)) {
+                        found = true;
+                        if (engine.isFirstImprovement()) return true;
+                    }
+                }
+            }
+        }
+    }
+    return found;
+}
+
+void OrOptMove::apply(Tour& tour, const LocalSearch::Improvement& improvement) const {
+    const int* nodes = improvement.nodes;
+    moveSegment(tour, nodes[0], nodes[1], nodes[2], nodes[3], nodes[4], nodes[5], improvement.variant == 1);
+}
+
+bool ThreeOptMove::search(const LocalSearch& engine, const Tour& tour, int a, LocalSearch::Improvement& improvement) const {
+    const CandidateSet& candidates = engine.getCandidates();
+    bool found = false;
+    for (int forward = 1; forward >= 0; forward--) {
+        // a b ... c d ... e f (in this direction) becomes a d ... e b ... c f.
+        const int b = forward ? tour.next(a) : tour.prev(a);
+        const double distAB = engine.dist(a, b);
+        const int* neighboursA = candidates.getNeighbours(a);
+        const double* neighbourDistsA = candidates.getDists(a);
+        for (int i = 0; i < candidates.getCount(a); i++) {
+            const double gain1 = distAB - neighbourDistsA[i];
+            if (gain1 <= 0) break;
+            const int d = neighboursA[i];
+            if (d == b) continue;
+            const int c = forward ? tour.prev(d) : tour.next(d);
+            const double distCD = engine.dist(c, d);
+            const int* neighboursC = candidates.getNeighbours(c);
+            const double* neighbourDistsC = candidates.getDists(c);
+            for (int j = 0; j < candidates.getCount(c); j++) {
+                const double gain2 = gain1 + distCD - neighbourDistsC[j];
+                if (gain2 <= 0) break;
+                const int f = neighboursC[j];
+                // f must be after d and before a.
+                if (f == d || f == a || !(forward ? tour.between(d, f, a) : tour.between(a, f, d))) continue;
+                const int e = forward ? tour.prev(f) : tour.next(f);
+                const double gain = gain2 + engine.dist(e, f) - engine.dist(e, b);
+                // Forward: move b..c between e and f. Backward (f e ... d c ... b a forward): move e..d between b and a.
+                const bool better = forward ? offer(improvement, gain, {a, b, c, d, e, f}, 0)
+                                            : offer(improvement, gain, {f, e, d, c, b, a}, 0);
+                if (better) {
+                    found = true;
+                    if (engine.isFirstImprovement()) return true;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+void ThreeOptMove::apply(Tour& tour, const LocalSearch::Improvement& improvement) const {
+    const int* nodes = improvement.nodes;
+    moveSegment(tour, nodes[0], nodes[1], nodes[2], nodes[3], nodes[4], nodes[5], false);
+}
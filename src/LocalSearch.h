@@ -0,0 +1,176 @@
+#ifndef CITYNETWORK_LOCALSEARCH_H
+#define CITYNETWORK_LOCALSEARCH_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "CandidateSet.h"
+#include "Tour.h"
+
+/**
+ * @class LocalSearch
+ * @brief Improves a tour with a configurable set of moves until none of them shortens it.
+ *
+ * Every move (see Move) looks for improvements "around" one node, using that node's candidate list to choose the new
+ * edges. The engine keeps a queue of nodes to look at (the others have their don't-look bit set): at first every
+ * node, then only the ends of the edges changed by a move. With firstImprovement, the first improving move found
+ * around a node is made; with bestImprovement, every move around the node is evaluated and the best one is made.
+ */
+class LocalSearch {
+public:
+    typedef std::function<double(int, int)> DistanceFunction; /**< Gives the distance between two nodes (INFINITY if there is no edge). */
+    static constexpr double epsilon = 1e-7; /**< The minimum gain of a move, so rounding errors don't cause endless loops. */
+
+    /**
+     * @brief How the engine chooses among the improving moves around a node.
+     */
+    enum Policy {
+        firstImprovement, /**< Make the first improving move found. */
+        bestImprovement /**< Make the improving move with the largest gain. */
+    };
+
+    /**
+     * @struct Improvement
+     * @brief An improving move found by a Move, to be made by the same Move.
+     */
+    struct Improvement {
+        double gain = 0; /**< How much shorter the tour gets. */
+        int nodes[6] = {-1, -1, -1, -1, -1, -1}; /**< The nodes involved (their meaning depends on the move). */
+        int nodeCount = 0; /**< The number of nodes involved, whose edges change. */
+        int variant = 0; /**< Which reconnection of the nodes is made (depends on the move). */
+        int moveIndex = -1; /**< The index of the Move that found it (set by the engine). */
+    };
+
+    /**
+     * @class Move
+     * @brief A kind of move the engine can make.
+     */
+    class Move {
+    public:
+        virtual ~Move() = default;
+        /**
+         * @brief Gets the name of the move, for reports.
+         * @return The name.
+         */
+        [[nodiscard]] virtual const char* getName() const = 0;
+        /**
+         * @brief Looks for improving moves around a node, keeping the best found in improvement.
+         * @param engine The engine (gives the distances and candidates).
+         * @param tour The tour.
+         * @param nodeId The ID of the node.
+         * @param improvement The best improvement so far, replaced by a better one if found.
+         * @return true if an improvement better than the given one was found.
+         */
+        virtual bool search(const LocalSearch& engine, const Tour& tour, int nodeId, Improvement& improvement) const = 0;
+        /**
+         * @brief Makes a move found by search().
+         * @param tour The tour.
+         * @param improvement The move.
+         */
+        virtual void apply(Tour& tour, const Improvement& improvement) const = 0;
+    };
+
+private:
+    DistanceFunction distFunction; /**< The distances between the nodes. */
+    const CandidateSet& candidates; /**< The candidates of every node. */
+    Policy policy; /**< How to choose among the improving moves around a node. */
+    std::vector<std::unique_ptr<Move>> moves; /**< The moves tried, in order. */
+    std::vector<unsigned long long> moveCounts; /**< How many times each move was made in the last run. */
+
+public:
+    /**
+     * @brief Constructs the engine, without moves.
+     * @param dist The distances between the nodes.
+     * @param candidates The candidates of every node.
+     * @param policy How to choose among the improving moves around a node.
+     */
+    LocalSearch(DistanceFunction dist, const CandidateSet& candidates, Policy policy = firstImprovement);
+
+    /**
+     * @brief Adds a kind of move to try (moves are tried in the order they were added).
+     * @param move The move.
+     */
+    void addMove(std::unique_ptr<Move> move);
+
+    /**
+     * @brief Gets the distance between two nodes.
+     * @param nodeId1 The ID of the first node.
+     * @param nodeId2 The ID of the second node.
+     * @return The distance.
+     */
+    [[nodiscard]] double dist(int nodeId1, int nodeId2) const { return distFunction(nodeId1, nodeId2); }
+    /**
+     * @brief Gets the candidates of every node.
+     * @return The candidate lists.
+     */
+    [[nodiscard]] const CandidateSet& getCandidates() const { return candidates; }
+    /**
+     * @brief Checks if the first improving move around a node is to be made right away.
+     * @return true with firstImprovement, false with bestImprovement.
+     */
+    [[nodiscard]] bool isFirstImprovement() const { return policy == firstImprovement; }
+    /**
+     * @brief Gets how many times a move was made in the last run.
+     * @param moveIndex The index of the move, in the order they were added.
+     * @return The number of times.
+     */
+    [[nodiscard]] unsigned long long getMoveCount(int moveIndex) const { return moveCounts[moveIndex]; }
+
+    /**
+     * @brief Improves the tour until none of the moves shortens it.
+     * @param tour The tour.
+     * @return The total gain.
+     */
+    double run(Tour& tour);
+};
+
+/**
+ * @class TwoOptMove
+ * @brief Removes two edges and reconnects the two paths left the other way, reversing one of them.
+ *
+ * The new edge at the node goes to one of its candidates, scanned nearest first, and the scan stops at the first one
+ * not shorter than the removed edge (the gain can't be positive after that).
+ */
+class TwoOptMove : public LocalSearch::Move {
+public:
+    [[nodiscard]] const char* getName() const override { return "2-opt"; }
+    bool search(const LocalSearch& engine, const Tour& tour, int nodeId, LocalSearch::Improvement& improvement) const override;
+    void apply(Tour& tour, const LocalSearch::Improvement& improvement) const override;
+};
+
+/**
+ * @class OrOptMove
+ * @brief Moves a path of 1 to 3 nodes that starts or ends at the node elsewhere in the tour, possibly reversed.
+ *
+ * The node gets one of its candidates as new neighbour, and the candidates are only scanned while that new edge is
+ * shorter than the gain of taking the path out.
+ */
+class OrOptMove : public LocalSearch::Move {
+    int maxLength; /**< The maximum number of nodes of the path moved. */
+public:
+    /**
+     * @brief Constructs the move.
+     * @param maxLength The maximum number of nodes of the path moved.
+     */
+    explicit OrOptMove(int maxLength = 3) : maxLength(maxLength) {}
+    [[nodiscard]] const char* getName() const override { return "Or-opt"; }
+    bool search(const LocalSearch& engine, const Tour& tour, int nodeId, LocalSearch::Improvement& improvement) const override;
+    void apply(Tour& tour, const LocalSearch::Improvement& improvement) const override;
+};
+
+/**
+ * @class ThreeOptMove
+ * @brief Restricted 3-opt: the segment-exchange reconnection (a b..c d..e f becomes a d..e b..c f), the only
+ * 3-opt move that reverses nothing.
+ *
+ * It is searched sequentially: both new edges that start a step of the chain (a to d and c to f) go to candidates
+ * and the partial gain must stay positive, so only O(k^2) moves are evaluated per node and direction.
+ */
+class ThreeOptMove : public LocalSearch::Move {
+public:
+    [[nodiscard]] const char* getName() const override { return "3-opt"; }
+    bool search(const LocalSearch& engine, const Tour& tour, int nodeId, LocalSearch::Improvement& improvement) const override;
+    void apply(Tour& tour, const LocalSearch::Improvement& improvement) const override;
+};
+
+#endif //CITYNETWORK_LOCALSEARCH_H
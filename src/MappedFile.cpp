@@ -0,0 +1,51 @@
+#include <fstream>
+#include <iterator>
+
+#include "MappedFile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+MappedFile::MappedFile(const string& file) : data(nullptr), size(0), mapped(false), open(false) {
+#ifndef _WIN32
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st{};
+        if (fstat(fd, &st) == 0) {
+            open = true;
+            size = st.st_size;
+            if (size > 0) {
+                void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr != MAP_FAILED) {
+                    madvise(addr, size, MADV_SEQUENTIAL);
+                    data = static_cast<const char*>(addr);
+                    mapped = true;
+                }
+            }
+        }
+        ::close(fd);
+        if (mapped || size == 0) {
+            if (data == nullptr) data = buffer.data();
+            return;
+        }
+    }
+#endif
+    // Fallback: read the file into memory.
+    ifstream in(file, ios::binary);
+    open = in.is_open();
+    buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (mapped) munmap(const_cast<char*>(data), size);
+#endif
+}
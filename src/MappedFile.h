@@ -0,0 +1,53 @@
+#ifndef CITYNETWORK_MAPPEDFILE_H
+#define CITYNETWORK_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Read-only view of a whole file, memory-mapped where the platform allows it.
+ *
+ * The contents are mapped straight from the page cache (mmap) so parsing them doesn't copy the file.
+ * On platforms without mmap the file is read into a buffer instead.
+ * A file that can't be opened behaves like an empty file, just like an std::ifstream would.
+ */
+class MappedFile {
+    const char* data; /**< The first byte of the file. */
+    size_t size; /**< The size of the file in bytes. */
+    bool mapped; /**< Whether data points to a memory mapping (true) or to buffer (false). */
+    bool open; /**< Whether the file could be opened. */
+    std::string buffer; /**< Holds the contents when the file couldn't be mapped. */
+public:
+    /**
+     * @brief Maps the given file.
+     * @param file The path to the file.
+     */
+    explicit MappedFile(const std::string& file);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    /**
+     * @brief Checks if the file could be opened.
+     * @return true if the file was opened, false otherwise.
+     */
+    [[nodiscard]] bool isOpen() const { return open; }
+    /**
+     * @brief Gets the first byte of the file.
+     * @return Pointer to the first byte.
+     */
+    [[nodiscard]] const char* begin() const { return data; }
+    /**
+     * @brief Gets the byte past the end of the file.
+     * @return Pointer to the byte past the end.
+     */
+    [[nodiscard]] const char* end() const { return data + size; }
+    /**
+     * @brief Gets the size of the file.
+     * @return The size in bytes.
+     */
+    [[nodiscard]] size_t getSize() const { return size; }
+};
+
+#endif //CITYNETWORK_MAPPEDFILE_H
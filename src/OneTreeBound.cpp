@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cmath>
+
+#include "OneTreeBound.h"
+
+using namespace std;
+
+OneTreeBound::OneTreeBound(int nodeCount, const RowFunction& rows) :
+    nodeCount(nodeCount), dist((size_t) nodeCount * nodeCount), penalties(nodeCount, 0), degrees(nodeCount, 0),
+    left(nodeCount), keys(nodeCount), parents(nodeCount), iterations(0), optimal(false) {
+    vector<double> row;
+    for (int i = 0; i < nodeCount; i++) {
+        rows(i, row);
+        float* out = &dist[(size_t) i * nodeCount];
+        for (int j = 0; j < nodeCount; j++) {
+            float value = (float) row[j];
+            if (value > row[j]) value = nextafter(value, -INFINITY);
+            out[j] = value;
+        }
+    }
+}
+
+double OneTreeBound::oneTree() {
+    fill(degrees.begin(), degrees.end(), 0);
+    // Prim's algorithm on the nodes 1 to V - 1, from node 1. Each pass over the nodes not in the tree updates their
+    // keys, finds the next minimum and drops the node added, keeping left in increasing order for the cache.
+    int leftCount = 0;
+    int minIndex = -1;
+    for (int v = 2; v < nodeCount; v++) {
+        left[leftCount] = v;
+        keys[leftCount] = dist[(size_t) nodeCount + v] + penalties[1] + penalties[v];
+        parents[leftCount] = 1;
+        if (minIndex < 0 || keys[leftCount] < keys[minIndex]) minIndex = leftCount;
+        leftCount++;
+    }
+    double cost = 0;
+    while (leftCount > 0) {
+        if (keys[minIndex] == INFINITY) return INFINITY; // Not connected.
+        const int u = left[minIndex];
+        cost += keys[minIndex];
+        degrees[u]++;
+        degrees[parents[minIndex]]++;
+        const float* row = &dist[(size_t) u * nodeCount];
+        const double penaltyU = penalties[u];
+        const int removed = minIndex;
+        double minKey = INFINITY;
+        minIndex = 0;
+        int kept = 0;
+        for (int i = 0; i < leftCount; i++) {
+            if (i == removed) continue;
+            const int v = left[i];
+            double key = keys[i];
+            int parent = parents[i];
+            const double weight = row[v] + penaltyU + penalties[v];
+            if (weight < key) {
+                key = weight;
+                parent = u;
+            }
+            left[kept] = v;
+            keys[kept] = key;
+            parents[kept] = parent;
+            if (key < minKey) {
+                minKey = key;
+                minIndex = kept;
+            }
+            kept++;
+        }
+        leftCount = kept;
+    }
+    // The two cheapest edges of node 0.
+    int first = -1, second = -1;
+    const float* row = dist.data();
+    for (int v = 1; v < nodeCount; v++) {
+        const double weight = row[v] + penalties[v];
+        if (first < 0 || weight < row[first] + penalties[first]) {
+            second = first;
+            first = v;
+        } else if (second < 0 || weight < row[second] + penalties[second]) second = v;
+    }
+    cost += row[first] + row[second] + 2 * penalties[0] + penalties[first] + penalties[second];
+    degrees[0] = 2;
+    degrees[first]++;
+    degrees[second]++;
+    return cost;
+}
+
+double OneTreeBound::compute() {
+    iterations = 0;
+    optimal = false;
+    if (nodeCount < 3) return 0;
+    fill(penalties.begin(), penalties.end(), 0);
+    double best = oneTree();
+    if (best == INFINITY) return INFINITY;
+    optimal = isTour();
+    if (optimal || best <= 0) return max(best, 0.0);
+    vector<int> lastDegrees = degrees;
+    double step = best / nodeCount / 2;
+    const double minStep = best / nodeCount * 1e-7;
+    int period = max(1, min(nodeCount / 2, maxPeriod));
+    bool initialPhase = true;
+    while (step > minStep && period > 0 && iterations < maxIterations) {
+        for (int p = 1; p <= period && iterations < maxIterations; p++) {
+            for (int i = 0; i < nodeCount; i++)
+                penalties[i] += step * (0.7 * (degrees[i] - 2) + 0.3 * (lastDegrees[i] - 2));
+            lastDegrees = degrees;
+            double penaltySum = 0;
+            for (double penalty : penalties) penaltySum += penalty;
+            const double bound = oneTree() - 2 * penaltySum;
+            iterations++;
+            if (bound > best) {
+                best = bound;
+                if (initialPhase) step *= 2;
+                if (p == period) period *= 2;
+            } else if (initialPhase && p > period / 2) {
+                initialPhase = false;
+                p = 0;
+                step = 3 * step / 4;
+            }
+            if (isTour()) {
+                optimal = bound >= best;
+                return best;
+            }
+        }
+        period /= 2;
+        step /= 2;
+    }
+    return best;
+}
+
+bool OneTreeBound::isTour() const {
+    for (int degree : degrees)
+        if (degree != 2) return false;
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef CITYNETWORK_ONETREEBOUND_H
+#define CITYNETWORK_ONETREEBOUND_H
+
+#include <functional>
+#include <vector>
+
+/**
+ * @class OneTreeBound
+ * @brief Computes the Held-Karp lower bound of the shortest tour: the 1-tree bound with node penalties refined by
+ * subgradient optimization.
+ *
+ * A 1-tree is a minimum spanning tree of the nodes other than node 0 plus the two cheapest edges of node 0, and no
+ * tour is shorter. Adding a penalty pi[i] to every edge of node i adds 2 * sum(pi) to every tour, so the 1-tree
+ * cost minus 2 * sum(pi) is a lower bound for any pi. Each iteration moves pi along the degree of every node minus 2
+ * (mixed with the previous direction), which makes the 1-tree closer to a tour. The step size follows Helsgaun's
+ * schedule: it doubles while the bound improves at first, then it and the number of iterations per period are halved
+ * after every period. If the 1-tree is a tour, the bound is the optimum.
+ *
+ * The distances are copied once into a dense row-major matrix of floats (rounded down, so the bound stays a lower
+ * bound), and every 1-tree is built with the array version of Prim's algorithm: a key per node and a linear scan for
+ * the minimum, O(V^2) per iteration with no heap.
+ */
+class OneTreeBound {
+public:
+    /**
+     * @brief Fills row with the distance from a node to every node (by index, INFINITY for the node itself).
+     */
+    typedef std::function<void(int, std::vector<double>&)> RowFunction;
+    static constexpr int maxIterations = 150; /**< The largest number of subgradient iterations. */
+    static constexpr int maxPeriod = 50; /**< The largest number of iterations of the first period (V / 2 if less). */
+
+private:
+    int nodeCount; /**< The number of nodes. */
+    std::vector<float> dist; /**< The distance from node i to node j at i * nodeCount + j. */
+    std::vector<double> penalties; /**< The penalty of every node. */
+    std::vector<int> degrees; /**< The degree of every node in the last 1-tree. */
+    std::vector<int> left; /**< Prim's algorithm: the nodes not in the tree yet. */
+    std::vector<double> keys; /**< Prim's algorithm: the cheapest edge from the tree to each of them. */
+    std::vector<int> parents; /**< Prim's algorithm: the tree node that edge goes to. */
+    int iterations; /**< The number of iterations of the last compute(). */
+    bool optimal; /**< Whether the last 1-tree was a tour. */
+
+    /**
+     * @brief Builds the 1-tree with the current penalties, setting degrees.
+     * @return Its cost, with the penalties.
+     */
+    double oneTree();
+    /**
+     * @brief Checks if every node of the last 1-tree has degree 2.
+     */
+    [[nodiscard]] bool isTour() const;
+
+public:
+    /**
+     * @brief Copies the distances.
+     * @param nodeCount The number of nodes.
+     * @param rows Gives the distances from every node.
+     */
+    OneTreeBound(int nodeCount, const RowFunction& rows);
+
+    /**
+     * @brief Computes the lower bound.
+     * @return The lower bound (INFINITY if there is no tour, as the 1-tree can't be built).
+     */
+    double compute();
+
+    /**
+     * @brief Gets the number of subgradient iterations of the last compute().
+     * @return The number of iterations.
+     */
+    [[nodiscard]] int getIterations() const { return iterations; }
+
+    /**
+     * @brief Checks if the last compute() found a 1-tree that is a tour, so the bound is the optimum.
+     * @return true if it did, false otherwise.
+     */
+    [[nodiscard]] bool isOptimal() const { return optimal; }
+};
+
+#endif //CITYNETWORK_ONETREEBOUND_H
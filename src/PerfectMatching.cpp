@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+#include "PerfectMatching.h"
+
+using namespace std;
+
+PerfectMatching::PerfectMatching(int n) : n(n), blossomCount(n), edges(2 * n + 1, vector<Edge>(2 * n + 1)),
+    labels(2 * n + 1, 0), mate(2 * n + 1, 0), slack(2 * n + 1, 0), top(2 * n + 1, 0), parent(2 * n + 1, 0),
+    flowerFrom(2 * n + 1, vector<int>(n + 1, 0)), side(2 * n + 1, -1), marks(2 * n + 1, 0), markCount(0),
+    flowers(2 * n + 1) {
+    for (int u = 1; u <= 2 * n; u++)
+        for (int v = 1; v <= 2 * n; v++) edges[u][v] = {u, v, 0};
+    for (int u = 0; u <= n; u++) {
+        top[u] = u;
+        if (u > 0) flowerFrom[u][u] = u;
+    }
+}
+
+void PerfectMatching::updateSlack(int u, int x) {
+    if (!slack[x] || delta(edges[u][x]) < delta(edges[slack[x]][x])) slack[x] = u;
+}
+
+void PerfectMatching::setSlack(int x) {
+    slack[x] = 0;
+    for (int u = 1; u <= n; u++)
+        if (edges[u][x].weight > 0 && top[u] != x && side[top[u]] == 0) updateSlack(u, x);
+}
+
+void PerfectMatching::push(int x) {
+    if (x <= n) queue.push_back(x);
+    else for (int sub : flowers[x]) push(sub);
+}
+
+void PerfectMatching::setTop(int x, int b) {
+    top[x] = b;
+    if (x > n) for (int sub : flowers[x]) setTop(sub, b);
+}
+
+int PerfectMatching::getEvenPosition(int b, int xr) {
+    // Puts xr at an even position of the cycle (the path from the base to it has an even length).
+    vector<int>& flower = flowers[b];
+    const int pos = (int) (find(flower.begin(), flower.end(), xr) - flower.begin());
+    if (pos % 2 == 0) return pos;
+    reverse(flower.begin() + 1, flower.end());
+    return (int) flower.size() - pos;
+}
+
+void PerfectMatching::setMatch(int u, int v) {
+    mate[u] = edges[u][v].v;
+    if (u <= n) return;
+    // Rotate the blossom so that the sub-blossom matched outside becomes its base.
+    const Edge e = edges[u][v];
+    const int xr = flowerFrom[u][e.u];
+    const int pos = getEvenPosition(u, xr);
+    for (int i = 0; i < pos; i++) setMatch(flowers[u][i], flowers[u][i ^ 1]);
+    setMatch(xr, v);
+    rotate(flowers[u].begin(), flowers[u].begin() + pos, flowers[u].end());
+}
+
+void PerfectMatching::augment(int u, int v) {
+    while (true) {
+        const int next = top[mate[u]];
+        setMatch(u, v);
+        if (!next) return;
+        setMatch(next, top[parent[next]]);
+        u = top[parent[next]];
+        v = next;
+    }
+}
+
+int PerfectMatching::lowestCommonAncestor(int u, int v) {
+    for (++markCount; u || v; swap(u, v)) {
+        if (u == 0) continue;
+        if (marks[u] == markCount) return u;
+        marks[u] = markCount;
+        u = top[mate[u]];
+        if (u) u = top[parent[u]];
+    }
+    return 0;
+}
+
+void PerfectMatching::addBlossom(int u, int lca, int v) {
+    int b = n + 1;
+    while (b <= blossomCount && top[b]) b++;
+    if (b > blossomCount) blossomCount++;
+    labels[b] = 0;
+    side[b] = 0;
+    mate[b] = mate[lca];
+    vector<int>& flower = flowers[b];
+    flower.clear();
+    flower.push_back(lca);
+    for (int x = u, y; x != lca; x = top[parent[y]]) {
+        flower.push_back(x);
+        flower.push_back(y = top[mate[x]]);
+        push(y);
+    }
+    reverse(flower.begin() + 1, flower.end());
+    for (int x = v, y; x != lca; x = top[parent[y]]) {
+        flower.push_back(x);
+        flower.push_back(y = top[mate[x]]);
+        push(y);
+    }
+    setTop(b, b);
+    for (int x = 1; x <= blossomCount; x++) edges[b][x].weight = edges[x][b].weight = 0;
+    for (int x = 1; x <= n; x++) flowerFrom[b][x] = 0;
+    for (int sub : flower) {
+        for (int x = 1; x <= blossomCount; x++)
+            if (edges[b][x].weight == 0 || delta(edges[sub][x]) < delta(edges[b][x])) {
+                edges[b][x] = edges[sub][x];
+                edges[x][b] = edges[x][sub];
+            }
+        for (int x = 1; x <= n; x++)
+            if (flowerFrom[sub][x]) flowerFrom[b][x] = sub;
+    }
+    setSlack(b);
+}
+
+void PerfectMatching::expandBlossom(int b) {
+    for (int sub : flowers[b]) setTop(sub, sub);
+    const int xr = flowerFrom[b][edges[b][parent[b]].u];
+    const int pos = getEvenPosition(b, xr);
+    // The sub-blossoms on the even path from the base to xr stay in the tree, the others leave it.
+    for (int i = 0; i < pos; i += 2) {
+        const int xs = flowers[b][i], xns = flowers[b][i + 1];
+        parent[xs] = edges[xns][xs].u;
+        side[xs] = 1;
+        side[xns] = 0;
+        slack[xs] = 0;
+        setSlack(xns);
+        push(xns);
+    }
+    side[xr] = 1;
+    parent[xr] = parent[b];
+    for (size_t i = pos + 1; i < flowers[b].size(); i++) {
+        const int xs = flowers[b][i];
+        side[xs] = -1;
+        setSlack(xs);
+    }
+    top[b] = 0;
+}
+
+bool PerfectMatching::onFoundEdge(const Edge& e) {
+    const int u = top[e.u], v = top[e.v];
+    if (side[v] == -1) {
+        // Grow the tree by v and its mate.
+        parent[v] = e.u;
+        side[v] = 1;
+        const int next = top[mate[v]];
+        slack[v] = slack[next] = 0;
+        side[next] = 0;
+        push(next);
+    } else if (side[v] == 0) {
+        const int lca = lowestCommonAncestor(u, v);
+        if (!lca) {
+            augment(u, v);
+            augment(v, u);
+            return true;
+        }
+        addBlossom(u, lca, v);
+    }
+    return false;
+}
+
+bool PerfectMatching::augmentOnce() {
+    fill(side.begin() + 1, side.begin() + blossomCount + 1, -1);
+    fill(slack.begin() + 1, slack.begin() + blossomCount + 1, 0);
+    queue.clear();
+    for (int x = 1; x <= blossomCount; x++)
+        if (top[x] == x && !mate[x]) {
+            parent[x] = 0;
+            side[x] = 0;
+            push(x);
+        }
+    if (queue.empty()) return false;
+    while (true) {
+        while (!queue.empty()) {
+            const int u = queue.front();
+            queue.pop_front();
+            if (side[top[u]] == 1) continue;
+            for (int v = 1; v <= n; v++)
+                if (edges[u][v].weight > 0 && top[u] != top[v]) {
+                    if (delta(edges[u][v]) == 0) {
+                        if (onFoundEdge(edges[u][v])) return true;
+                    } else updateSlack(u, top[v]);
+                }
+        }
+        // Adjust the duals by the largest amount that keeps them feasible.
+        long long d = numeric_limits<long long>::max();
+        for (int b = n + 1; b <= blossomCount; b++)
+            if (top[b] == b && side[b] == 1) d = min(d, labels[b] / 2);
+        for (int x = 1; x <= blossomCount; x++)
+            if (top[x] == x && slack[x]) {
+                if (side[x] == -1) d = min(d, delta(edges[slack[x]][x]));
+                else if (side[x] == 0) d = min(d, delta(edges[slack[x]][x]) / 2);
+            }
+        for (int u = 1; u <= n; u++) {
+            if (side[top[u]] == 0) {
+                if (labels[u] <= d) return false;
+                labels[u] -= d;
+            } else if (side[top[u]] == 1) labels[u] += d;
+        }
+        for (int b = n + 1; b <= blossomCount; b++)
+            if (top[b] == b) {
+                if (side[b] == 0) labels[b] += d * 2;
+                else if (side[b] == 1) labels[b] -= d * 2;
+            }
+        queue.clear();
+        for (int x = 1; x <= blossomCount; x++)
+            if (top[x] == x && slack[x] && top[slack[x]] != x && delta(edges[slack[x]][x]) == 0)
+                if (onFoundEdge(edges[slack[x]][x])) return true;
+        for (int b = n + 1; b <= blossomCount; b++)
+            if (top[b] == b && side[b] == 1 && labels[b] == 0) expandBlossom(b);
+    }
+}
+
+vector<int> PerfectMatching::exact(const vector<double>& dist, int count) {
+    if (count % 2 || count == 0) return {};
+    double maxDist = 0;
+    for (int i = 0; i < count; i++)
+        for (int j = 0; j < count; j++)
+            if (i != j && dist[(size_t) i * count + j] < INFINITY) maxDist = max(maxDist, dist[(size_t) i * count + j]);
+    if (maxDist == 0) maxDist = 1;
+    // Any perfect matching weighs more than any smaller matching: big is more than the cost of a perfect matching.
+    const long long big = (long long) (count / 2 + 1) * ((long long) scale + 1);
+    PerfectMatching matching(count);
+    long long maxWeight = 0;
+    for (int i = 0; i < count; i++)
+        for (int j = 0; j < count; j++) {
+            const double d = dist[(size_t) i * count + j];
+            if (i == j || d == INFINITY) continue;
+            const long long weight = big - llround(d / maxDist * scale);
+            matching.edges[i + 1][j + 1].weight = weight;
+            maxWeight = max(maxWeight, weight);
+        }
+    for (int u = 1; u <= count; u++) matching.labels[u] = maxWeight;
+    int matched = 0;
+    while (matching.augmentOnce()) matched++;
+    if (matched * 2 != count) return {};
+    vector<int> result(count);
+    for (int u = 1; u <= count; u++) result[u - 1] = matching.mate[u] - 1;
+    return result;
+}
+
+vector<int> PerfectMatching::greedy(const vector<double>& dist, int count) {
+    if (count % 2 || count == 0) return {};
+    vector<tuple<double, int, int>> pairs;
+    pairs.reserve((size_t) count * (count - 1) / 2);
+    for (int i = 0; i < count; i++)
+        for (int j = i + 1; j < count; j++)
+            if (dist[(size_t) i * count + j] < INFINITY) pairs.emplace_back(dist[(size_t) i * count + j], i, j);
+    sort(pairs.begin(), pairs.end());
+    vector<int> result(count, -1);
+    int matched = 0;
+    for (const auto& [d, i, j] : pairs) {
+        if (result[i] >= 0 || result[j] >= 0) continue;
+        result[i] = j;
+        result[j] = i;
+        if (++matched * 2 == count) return result;
+    }
+    return {};
+}
@@ -0,0 +1,85 @@
+#ifndef CITYNETWORK_PERFECTMATCHING_H
+#define CITYNETWORK_PERFECTMATCHING_H
+
+#include <deque>
+#include <vector>
+
+/**
+ * @class PerfectMatching
+ * @brief Minimum-weight perfect matchings of complete graphs, exact (weighted blossom algorithm) or greedy.
+ *
+ * The exact matching is Edmonds' blossom algorithm with dual variables, in the O(V^3) form: each augmenting path is
+ * grown from all the free vertices at once, the odd cycles found are shrunk into blossoms (and expanded again when
+ * their dual reaches 0), and the duals are adjusted by the smallest slack when the search gets stuck. It finds a
+ * maximum-weight matching, so every weight is turned into a large constant minus the distance (making every maximum
+ * matching perfect), and the distances are scaled to integers (the duals stay exact).
+ *
+ * The greedy matching repeatedly matches the closest pair of unmatched vertices, in O(V^2 log V).
+ */
+class PerfectMatching {
+public:
+    static constexpr int exactLimit = 600; /**< The largest number of vertices matched exactly by default. */
+    static constexpr double scale = 1 << 24; /**< The integer units the largest distance is scaled to. */
+
+private:
+    /**
+     * @struct Edge
+     * @brief An edge of the (shrunk) graph: the original vertices it joins and its weight.
+     */
+    struct Edge {
+        int u, v; /**< The original vertices (1 to n). */
+        long long weight; /**< The weight (0 if there is no edge). */
+    };
+    int n; /**< The number of vertices, numbered from 1. */
+    int blossomCount; /**< The highest vertex or blossom number in use. */
+    std::vector<std::vector<Edge>> edges; /**< The edge between any two vertices or blossoms. */
+    std::vector<long long> labels; /**< The dual variable of every vertex and blossom. */
+    std::vector<int> mate; /**< The vertex or blossom matched to each one (0 if none). */
+    std::vector<int> slack; /**< The vertex giving the smallest slack edge to each blossom. */
+    std::vector<int> top; /**< The outermost blossom containing each vertex or blossom. */
+    std::vector<int> parent; /**< The vertex an S vertex was reached from, in the alternating tree. */
+    std::vector<std::vector<int>> flowerFrom; /**< The sub-blossom of a blossom that contains a vertex. */
+    std::vector<int> side; /**< The side of each blossom in the alternating tree: 0 (S), 1 (T) or -1 (none). */
+    std::vector<int> marks; /**< The last search that visited each blossom, to find the lowest common ancestor. */
+    int markCount; /**< The number of lowest common ancestor searches. */
+    std::vector<std::vector<int>> flowers; /**< The sub-blossoms of every blossom, in cycle order from the base. */
+    std::deque<int> queue; /**< The S vertices to scan. */
+
+    [[nodiscard]] long long delta(const Edge& e) const { return labels[e.u] + labels[e.v] - e.weight * 2; }
+    void updateSlack(int u, int x);
+    void setSlack(int x);
+    void push(int x);
+    void setTop(int x, int b);
+    int getEvenPosition(int b, int xr);
+    void setMatch(int u, int v);
+    void augment(int u, int v);
+    int lowestCommonAncestor(int u, int v);
+    void addBlossom(int u, int lca, int v);
+    void expandBlossom(int b);
+    bool onFoundEdge(const Edge& e);
+    bool augmentOnce();
+
+    /**
+     * @brief Prepares the weighted blossom algorithm for n vertices.
+     */
+    explicit PerfectMatching(int n);
+
+public:
+    /**
+     * @brief Finds a perfect matching of minimum total distance.
+     * @param dist The distance between vertices i and j at i * count + j (INFINITY if they can't be matched).
+     * @param count The number of vertices (even).
+     * @return The vertex matched to every vertex, or an empty vector if there is no perfect matching.
+     */
+    static std::vector<int> exact(const std::vector<double>& dist, int count);
+
+    /**
+     * @brief Finds a perfect matching by matching the closest unmatched vertices first.
+     * @param dist The distance between vertices i and j at i * count + j (INFINITY if they can't be matched).
+     * @param count The number of vertices (even).
+     * @return The vertex matched to every vertex, or an empty vector if there is no perfect matching.
+     */
+    static std::vector<int> greedy(const std::vector<double>& dist, int count);
+};
+
+#endif //CITYNETWORK_PERFECTMATCHING_H
@@ -0,0 +1,189 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <system_error>
+
+#include "Snapshot.h"
+#include "CityNetwork.h"
+
+using namespace std;
+
+namespace {
+    const char magic[8] = {'C', 'N', 'S', 'N', 'A', 'P', '\0', '\0'};
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t graphType;
+        uint64_t nodesSize;
+        uint64_t nodeCount;
+        uint64_t edgeCount;
+        uint64_t fakeEdgeCount;
+        uint64_t labelBytes;
+        uint32_t sourceCount;
+        uint32_t padding;
+    };
+
+    struct SourceStamp {
+        uint64_t size;
+        int64_t modified;
+        bool operator==(const SourceStamp& other) const { return size == other.size && modified == other.modified; }
+    };
+
+    SourceStamp getStamp(const string& file) {
+        error_code ec;
+        uint64_t size = filesystem::file_size(file, ec);
+        if (ec) return {UINT64_MAX, 0}; // Missing file.
+        auto modified = filesystem::last_write_time(file, ec);
+        if (ec) return {UINT64_MAX, 0};
+        return {size, (int64_t) modified.time_since_epoch().count()};
+    }
+
+    /**
+     * @brief Writes arrays to the file, keeping each one aligned to 8 bytes.
+     */
+    class Writer {
+        ofstream& out;
+        uint64_t written = 0;
+    public:
+        explicit Writer(ofstream& out) : out(out) {}
+        void write(const void* data, size_t bytes) {
+            out.write(static_cast<const char*>(data), (streamsize) bytes);
+            written += bytes;
+            static const char zeros[8] = {};
+            size_t padding = (8 - written % 8) % 8;
+            out.write(zeros, (streamsize) padding);
+            written += padding;
+        }
+    };
+
+    /**
+     * @brief Reads arrays back from the mapped file, checking they fit in it.
+     */
+    class Reader {
+        const char* pos;
+        const char* end;
+    public:
+        Reader(const char* begin, const char* end) : pos(begin), end(end) {}
+        template <typename T>
+        const T* take(size_t count) {
+            size_t bytes = count * sizeof(T);
+            if (bytes / sizeof(T) != count || (size_t) (end - pos) < bytes) return nullptr;
+            const T* data = reinterpret_cast<const T*>(pos);
+            pos += bytes + (8 - bytes % 8) % 8;
+            if (pos > end) pos = end;
+            return data;
+        }
+    };
+}
+
+string Snapshot::getPath(const string& datasetPath, bool isDirectory) {
+    return isDirectory ? datasetPath + "graph.snapshot" : datasetPath + ".snapshot";
+}
+
+bool Snapshot::save(const CityNetwork& cityNet, const string& snapshotFile, const vector<string>& sources) {
+    const vector<CityNetwork::Node>& nodes = cityNet.nodes;
+    const DistanceMatrix& distances = cityNet.distances;
+    if (distances.size() != nodes.size()) return false;
+
+    vector<int32_t> ids;
+    vector<double> lats, lons;
+    vector<uint64_t> labelOffsets = {0};
+    string labels;
+    for (const CityNetwork::Node& node : nodes) {
+        ids.push_back(node.id);
+        lats.push_back(node.lat);
+        lons.push_back(node.lon);
+        labels += node.label;
+        labelOffsets.push_back(labels.size());
+    }
+    vector<SourceStamp> stamps;
+    for (const string& source : sources) stamps.push_back(getStamp(source));
+
+    Header header{};
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.graphType = cityNet.graphType;
+    header.nodesSize = nodes.size();
+    header.nodeCount = cityNet.nodeCount;
+    header.edgeCount = cityNet.edgeCount;
+    header.fakeEdgeCount = cityNet.fakeEdgeCount;
+    header.labelBytes = labels.size();
+    header.sourceCount = stamps.size();
+
+    const string tempFile = snapshotFile + ".tmp";
+    {
+        ofstream out(tempFile, ios::binary | ios::trunc);
+        if (!out) return false;
+        Writer writer(out);
+        writer.write(&header, sizeof(header));
+        writer.write(stamps.data(), stamps.size() * sizeof(SourceStamp));
+        writer.write(ids.data(), ids.size() * sizeof(int32_t));
+        writer.write(lats.data(), lats.size() * sizeof(double));
+        writer.write(lons.data(), lons.size() * sizeof(double));
+        writer.write(labelOffsets.data(), labelOffsets.size() * sizeof(uint64_t));
+        writer.write(labels.data(), labels.size());
+        writer.write(distances.getDists(), distances.pairCount() * sizeof(double));
+        const vector<uint64_t>& valid = distances.getValidEdges().getWords();
+        writer.write(valid.data(), valid.size() * sizeof(uint64_t));
+        const vector<uint64_t>& real = distances.getRealEdges().getWords();
+        writer.write(real.data(), real.size() * sizeof(uint64_t));
+        if (!out.flush()) {
+            out.close();
+            filesystem::remove(tempFile);
+            return false;
+        }
+    }
+    error_code ec;
+    filesystem::rename(tempFile, snapshotFile, ec);
+    if (ec) filesystem::remove(tempFile, ec);
+    return !ec;
+}
+
+bool Snapshot::load(CityNetwork& cityNet, const string& snapshotFile, const vector<string>& sources) {
+    if (!filesystem::exists(snapshotFile)) return false;
+    auto file = make_shared<const MappedFile>(snapshotFile);
+    Reader reader(file->begin(), file->end());
+
+    const Header* header = reader.take<Header>(1);
+    if (header == nullptr || memcmp(header->magic, magic, sizeof(magic)) != 0) return false;
+    if (header->version != version || header->sourceCount != sources.size()) return false;
+    const SourceStamp* stamps = reader.take<SourceStamp>(header->sourceCount);
+    if (stamps == nullptr) return false;
+    for (size_t i = 0; i < sources.size(); i++)
+        if (!(stamps[i] == getStamp(sources[i]))) return false; // Stale.
+
+    const size_t nodesSize = header->nodesSize;
+    const size_t pairs = nodesSize * (nodesSize - (nodesSize > 0)) / 2;
+    const size_t words = (pairs + 63) / 64;
+    const int32_t* ids = reader.take<int32_t>(nodesSize);
+    const double* lats = reader.take<double>(nodesSize);
+    const double* lons = reader.take<double>(nodesSize);
+    const uint64_t* labelOffsets = reader.take<uint64_t>(nodesSize + 1);
+    const char* labels = reader.take<char>(header->labelBytes);
+    const double* dists = reader.take<double>(pairs);
+    const uint64_t* valid = reader.take<uint64_t>(words);
+    const uint64_t* real = reader.take<uint64_t>(words);
+    if (ids == nullptr || lats == nullptr || lons == nullptr || labelOffsets == nullptr || labels == nullptr ||
+        dists == nullptr || valid == nullptr || real == nullptr) return false; // Truncated.
+    for (size_t i = 0; i < nodesSize; i++)
+        if (labelOffsets[i] > labelOffsets[i + 1]) return false;
+    if (labelOffsets[0] != 0 || labelOffsets[nodesSize] != header->labelBytes) return false;
+
+    cityNet.nodes.resize(nodesSize);
+    for (size_t i = 0; i < nodesSize; i++) {
+        CityNetwork::Node& node = cityNet.nodes[i];
+        node.id = ids[i];
+        node.lat = lats[i];
+        node.lon = lons[i];
+        node.label.assign(labels + labelOffsets[i], labels + labelOffsets[i + 1]);
+    }
+    cityNet.graphType = static_cast<CityNetwork::GraphType>(header->graphType);
+    cityNet.nodeCount = header->nodeCount;
+    cityNet.edgeCount = header->edgeCount;
+    cityNet.fakeEdgeCount = header->fakeEdgeCount;
+    cityNet.distances.assignMapped(nodesSize, dists, file, Bitset(pairs, valid), Bitset(pairs, real));
+    return true;
+}
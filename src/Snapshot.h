@@ -0,0 +1,49 @@
+#ifndef CITYNETWORK_SNAPSHOT_H
+#define CITYNETWORK_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+
+class CityNetwork;
+
+/**
+ * @class Snapshot
+ * @brief Saves a loaded CityNetwork to a binary file and loads it back without parsing or completing it again.
+ *
+ * A snapshot holds the node table (IDs, coordinates and labels), the counters and the completed distance matrix,
+ * laid out so that the matrix can be used straight from the memory-mapped file.
+ * It also records the size and modification time of the CSV files it was made from, and is ignored as soon as
+ * any of them changes. The format is versioned and uses the machine's native byte order.
+ */
+class Snapshot {
+public:
+    static const unsigned int version = 1; /**< The version of the format written. */
+
+    /**
+     * @brief Gets the path of the snapshot of a dataset.
+     * @param datasetPath The path given to CityNetwork::initializeData.
+     * @param isDirectory Flag indicating if the datasetPath is a directory.
+     * @return The path of the snapshot file.
+     */
+    static std::string getPath(const std::string& datasetPath, bool isDirectory);
+
+    /**
+     * @brief Writes the snapshot of a city network (written to a temporary file first, then renamed).
+     * @param cityNet The loaded city network.
+     * @param snapshotFile The path of the snapshot file.
+     * @param sources The CSV files the city network was loaded from.
+     * @return true if the snapshot was written, false otherwise.
+     */
+    static bool save(const CityNetwork& cityNet, const std::string& snapshotFile, const std::vector<std::string>& sources);
+
+    /**
+     * @brief Loads a city network from its snapshot, if the snapshot exists and is up to date.
+     * @param cityNet The city network to load into (must be cleared).
+     * @param snapshotFile The path of the snapshot file.
+     * @param sources The CSV files the city network would be loaded from.
+     * @return true if the city network was loaded, false if it must be loaded from the CSV files.
+     */
+    static bool load(CityNetwork& cityNet, const std::string& snapshotFile, const std::vector<std::string>& sources);
+};
+
+#endif //CITYNETWORK_SNAPSHOT_H
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "SolverService.h"
+
+using namespace std;
+
+SolverService::SolverService(shared_ptr<const CityNetwork> network, unsigned int threadCount) :
+    network(std::move(network)), pool(threadCount) {}
+
+CityNetwork::Path SolverService::run(const CityNetwork& network, Algorithm algorithm, int startId) {
+    switch (algorithm) {
+        case algorithmNearestNeighbor: return network.nearestNeighbor(startId);
+        case algorithmGreedy: return network.greedyAlgorithm();
+        case algorithmChristofides: return network.christofides();
+        case algorithmTwoOpt: return network.twoOpt(network.nearestNeighbor(startId));
+        case algorithmLinKernighan: return network.linKernighan(network.greedyAlgorithm());
+    }
+    throw std::invalid_argument("Unknown algorithm!");
+}
+
+CityNetwork::Path SolverService::solve(const Request& request) const {
+    CityNetwork::Path path;
+    if (request.nodeIds.empty()) {
+        if (!network->nodeExists(request.startId)) throw std::out_of_range("There isn't a node " + to_string(request.startId) + "!");
+        path = run(*network, request.algorithm, request.startId);
+    } else {
+        const auto start = find(request.nodeIds.begin(), request.nodeIds.end(), request.startId);
+        if (start == request.nodeIds.end())
+            throw std::invalid_argument("The start node " + to_string(request.startId) + " isn't among the nodes to visit!");
+        // Solved on a copy of just those nodes, numbered by their index in nodeIds, then mapped back.
+        CityNetwork subnetwork = network->subnetwork(request.nodeIds);
+        subnetwork.setThreadCount(1); // The pool already runs a request per thread.
+        const CityNetwork::Path subnetworkPath = run(subnetwork, request.algorithm, (int) (start - request.nodeIds.begin()));
+        if (!subnetworkPath.isValid()) return CityNetwork::Path(INFINITY);
+        vector<int> order;
+        order.reserve(subnetworkPath.getPathSize());
+        for (int index : subnetworkPath.getOrder()) order.push_back(request.nodeIds[index]);
+        path = CityNetwork::Path(std::move(order), subnetworkPath.getDists());
+    }
+    // Rotate the tour to begin at the start node.
+    const int startPosition = path.getPosition(request.startId);
+    if (!path.isValid() || startPosition <= 0) return path;
+    vector<int> order = path.getOrder();
+    vector<double> dists = path.getDists();
+    rotate(order.begin(), order.begin() + startPosition, order.end());
+    rotate(dists.begin(), dists.begin() + startPosition, dists.end());
+    return CityNetwork::Path(std::move(order), std::move(dists));
+}
+
+future<CityNetwork::Path> SolverService::submit(Request request) {
+    auto task = make_shared<packaged_task<CityNetwork::Path()>>([this, request = std::move(request)] { return solve(request); });
+    future<CityNetwork::Path> result = task->get_future();
+    pool.submit([task] { (*task)(); });
+    return result;
+}
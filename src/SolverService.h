@@ -0,0 +1,90 @@
+#ifndef CITYNETWORK_SOLVERSERVICE_H
+#define CITYNETWORK_SOLVERSERVICE_H
+
+#include <future>
+#include <memory>
+#include <vector>
+#include "CityNetwork.h"
+#include "ThreadPool.h"
+
+/**
+ * @class SolverService
+ * @brief Answers routing requests on one loaded city network, many at once, on a thread pool.
+ *
+ * The network is shared read-only by every request: the algorithms keep their state in workspaces of their own (see
+ * Workspace), so requests never wait for each other except to build the data kept on first use (e.g. the candidate
+ * lists). Requests on some of the nodes are solved on a copy of just those nodes (see CityNetwork::subnetwork()), made
+ * by the request itself.
+ */
+class SolverService {
+public:
+    /**
+     * @brief The algorithms a request can use.
+     */
+    enum Algorithm {
+        algorithmNearestNeighbor, /**< The nearest neighbor tour from the start node (see CityNetwork::nearestNeighbor()). */
+        algorithmGreedy, /**< The greedy tour (see CityNetwork::greedyAlgorithm()). */
+        algorithmChristofides, /**< Christofides' tour (see CityNetwork::christofides()). */
+        algorithmTwoOpt, /**< The nearest neighbor tour from the start node improved by CityNetwork::twoOpt(). */
+        algorithmLinKernighan /**< The greedy tour improved by CityNetwork::linKernighan(). */
+    };
+
+    /**
+     * @struct Request
+     * @brief A routing request: a tour through some nodes, from a start node.
+     */
+    struct Request {
+        Algorithm algorithm = algorithmNearestNeighbor; /**< The algorithm that builds the tour. */
+        int startId = 0; /**< The ID of the node the tour starts at. */
+        std::vector<int> nodeIds; /**< The IDs of the nodes to visit, the start node among them (empty for every node). */
+    };
+
+private:
+    std::shared_ptr<const CityNetwork> network; /**< The network every request is answered on. */
+    ThreadPool pool; /**< Runs the requests submitted. */
+
+    /**
+     * @brief Runs an algorithm on a network.
+     */
+    static CityNetwork::Path run(const CityNetwork& network, Algorithm algorithm, int startId);
+
+public:
+    /**
+     * @brief Starts the service.
+     * @param network The network to answer the requests on, which must not be changed while the service exists.
+     * @param threadCount The number of requests solved at once (at least 1).
+     */
+    SolverService(std::shared_ptr<const CityNetwork> network, unsigned int threadCount);
+
+    /**
+     * @brief Gets the number of requests solved at once.
+     * @return The number of threads of the pool.
+     */
+    [[nodiscard]] unsigned int getThreadCount() const { return pool.size(); }
+
+    /**
+     * @brief Gets the network the requests are answered on, e.g. to build the edges of a tour (see
+     * CityNetwork::getEdges()) after the service is gone.
+     * @return The shared network.
+     */
+    [[nodiscard]] std::shared_ptr<const CityNetwork> getNetwork() const { return network; }
+
+    /**
+     * @brief Solves a request on the calling thread.
+     * @param request The request.
+     * @return The tour, starting at the start node, with the IDs of the shared network (an invalid path if there is
+     * none). It doesn't refer to the service, so it can outlive it.
+     * @throws std::out_of_range If one of the nodes doesn't exist.
+     * @throws std::invalid_argument If the start node isn't among the nodes to visit or a node is given more than once.
+     */
+    [[nodiscard]] CityNetwork::Path solve(const Request& request) const;
+
+    /**
+     * @brief Queues a request, to be solved by one of the threads of the pool (see solve()).
+     * @param request The request.
+     * @return The tour, when it is ready, or the exception solve() threw.
+     */
+    std::future<CityNetwork::Path> submit(Request request);
+};
+
+#endif //CITYNETWORK_SOLVERSERVICE_H
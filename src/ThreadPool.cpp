@@ -0,0 +1,82 @@
+#include <utility>
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(unsigned int threadCount) : pending(0), queued(0), stopping(false), nextQueue(0) {
+    threadCount = max(threadCount, 1u);
+    for (unsigned int i = 0; i < threadCount; i++) queues.push_back(make_unique<Queue>());
+    for (unsigned int i = 0; i < threadCount; i++) workers.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        unique_lock<mutex> lock(stateMutex);
+        allDone.wait(lock, [this] { return pending == 0; });
+        stopping = true;
+    }
+    taskAdded.notify_all();
+    for (thread &worker : workers) worker.join();
+}
+
+void ThreadPool::submit(Task task) {
+    Queue &queue = *queues[nextQueue++ % queues.size()];
+    {
+        lock_guard<mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        lock_guard<mutex> lock(stateMutex);
+        pending++;
+        queued++;
+    }
+    taskAdded.notify_one();
+}
+
+void ThreadPool::wait() {
+    unique_lock<mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return pending == 0; });
+    if (error) rethrow_exception(exchange(error, nullptr));
+}
+
+bool ThreadPool::take(unsigned int index, Task& task) {
+    for (size_t i = 0; i < queues.size(); i++) {
+        Queue &queue = *queues[(index + i) % queues.size()];
+        lock_guard<mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        if (i == 0) { // Own queue: the newest task.
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else { // Stolen: the oldest task.
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::work(unsigned int index) {
+    while (true) {
+        {
+            unique_lock<mutex> lock(stateMutex);
+            taskAdded.wait(lock, [this] { return stopping || queued > 0; });
+            if (stopping) return;
+            queued--; // Claims one of the queued tasks, which take() is then sure to find.
+        }
+        Task task;
+        while (!take(index, task)) this_thread::yield();
+        exception_ptr taskError;
+        try {
+            task();
+        } catch (...) {
+            taskError = current_exception();
+        }
+        {
+            lock_guard<mutex> lock(stateMutex);
+            if (taskError && !error) error = taskError;
+            if (--pending == 0) allDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef CITYNETWORK_THREADPOOL_H
+#define CITYNETWORK_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief A fixed set of worker threads that run submitted tasks, balancing the load by work stealing.
+ *
+ * Every worker has its own task queue. Submitted tasks are dealt to the queues in turn; a worker takes the most
+ * recent task of its own queue and, when it is empty, steals the oldest task of another queue. Each queue has its
+ * own lock, so workers only contend for a queue when stealing. Every task also takes the shared state lock three
+ * times, briefly: when it is submitted, claimed and finished, to count the tasks and wake the waiting threads.
+ */
+class ThreadPool {
+public:
+    typedef std::function<void()> Task; /**< A unit of work. */
+
+private:
+    /**
+     * @struct Queue
+     * @brief The tasks of one worker.
+     */
+    struct Queue {
+        std::mutex mutex; /**< Guards tasks. */
+        std::deque<Task> tasks; /**< The tasks, oldest first. */
+    };
+    std::vector<std::unique_ptr<Queue>> queues; /**< The queue of every worker. */
+    std::vector<std::thread> workers; /**< The worker threads. */
+    std::mutex stateMutex; /**< Guards pending, stopping and error, and is used by the condition variables. */
+    std::condition_variable taskAdded; /**< Wakes the idle workers. */
+    std::condition_variable allDone; /**< Wakes the threads waiting for the tasks to end. */
+    size_t pending; /**< The number of tasks submitted and not finished. */
+    size_t queued; /**< The number of tasks in the queues. */
+    bool stopping; /**< Whether the workers must exit. */
+    std::exception_ptr error; /**< The first exception thrown by a task. */
+    std::atomic<unsigned int> nextQueue; /**< The queue the next task is given to. */
+
+    /**
+     * @brief Takes a task, from the worker's own queue or stolen from another one.
+     * @return true if a task was taken, false if every queue is empty.
+     */
+    bool take(unsigned int index, Task& task);
+    /**
+     * @brief The loop of a worker thread.
+     */
+    void work(unsigned int index);
+
+public:
+    /**
+     * @brief Starts the workers.
+     * @param threadCount The number of worker threads (at least 1).
+     */
+    explicit ThreadPool(unsigned int threadCount);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    /**
+     * @brief Waits for the tasks submitted and stops the workers.
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return The number of workers.
+     */
+    [[nodiscard]] unsigned int size() const { return (unsigned int) workers.size(); }
+
+    /**
+     * @brief Queues a task. It may be called from inside a task.
+     * @param task The task.
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Waits until every task submitted has finished.
+     * @throws The first exception thrown by a task since the last wait, if any.
+     */
+    void wait();
+};
+
+#endif //CITYNETWORK_THREADPOOL_H
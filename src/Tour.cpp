@@ -0,0 +1,52 @@
+#include <utility>
+
+#include "Tour.h"
+
+using namespace std;
+
+Tour::Tour(const vector<int>& order, size_t idCount) : order(order), positions(idCount, -1) {
+    for (int pos = 0; pos < (int) order.size(); pos++) positions[order[pos]] = pos;
+}
+
+void Tour::reverse(int from, int to) {
+    const int size = (int) order.size();
+    int i = positions[from];
+    const int j = positions[to];
+    int length = j - i;
+    if (length < 0) length += size;
+    length++; // Nodes in the path.
+    if (2 * length > size) { // Reverse the rest of the tour instead.
+        i = j + 1 == size ? 0 : j + 1;
+        length = size - length;
+    }
+    if (journaling) journal.emplace_back(i, length);
+    reverseRange(i, length);
+}
+
+void Tour::reverseRange(int i, int length) {
+    const int size = (int) order.size();
+    int j = i + length - 1;
+    if (j >= size) j -= size;
+    for (int swaps = length / 2; swaps > 0; swaps--) {
+        swap(order[i], order[j]);
+        positions[order[i]] = i;
+        positions[order[j]] = j;
+        if (++i == size) i = 0;
+        if (--j < 0) j = size - 1;
+    }
+}
+
+void Tour::rollback() {
+    // Reversing a range again restores it, so the journal is replayed backwards.
+    for (auto it = journal.rbegin(); it != journal.rend(); ++it) reverseRange(it->first, it->second);
+    journal.clear();
+}
+
+vector<int> Tour::getOrder(int startId) const {
+    vector<int> result;
+    result.reserve(order.size());
+    const int start = positions[startId];
+    for (int pos = start; pos < (int) order.size(); pos++) result.push_back(order[pos]);
+    for (int pos = 0; pos < start; pos++) result.push_back(order[pos]);
+    return result;
+}
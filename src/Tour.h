@@ -0,0 +1,124 @@
+#ifndef CITYNETWORK_TOUR_H
+#define CITYNETWORK_TOUR_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @class Tour
+ * @brief A cyclic tour stored as an array of node IDs plus the position of every node in it.
+ *
+ * Finding the successor or predecessor of a node, or checking the order of three nodes, takes O(1). Reversing a path
+ * of the tour takes time proportional to the shorter of the path and the rest of the tour (reversing the rest instead
+ * gives the same cycle, travelled the other way).
+ *
+ * After a checkpoint, the tour keeps a journal of the ranges of the array it reversed, so the moves made since can be
+ * undone in the time they took, instead of keeping a copy of the tour.
+ */
+class Tour {
+    std::vector<int> order; /**< The node IDs, in visiting order. */
+    std::vector<int> positions; /**< The position of every node ID in order (-1 if it isn't in the tour). */
+    std::vector<std::pair<int, int>> journal; /**< The first position and length of every range reversed since the checkpoint. */
+    bool journaling = false; /**< Whether the reversals are recorded (from the first checkpoint on). */
+
+    /**
+     * @brief Reverses a range of the array, which may wrap around its end.
+     * @param i The position of the first node of the range.
+     * @param length The number of nodes of the range.
+     */
+    void reverseRange(int i, int length);
+public:
+    /**
+     * @brief Constructs a tour visiting the given nodes in order.
+     * @param order The IDs of the nodes, in visiting order.
+     * @param idCount The number of node IDs (the highest ID plus one).
+     */
+    Tour(const std::vector<int>& order, size_t idCount);
+    /**
+     * @brief Gets the number of nodes of the tour.
+     * @return The number of nodes.
+     */
+    [[nodiscard]] int size() const { return (int) order.size(); }
+    /**
+     * @brief Gets the node at a position.
+     * @param pos The position (0 to size() - 1).
+     * @return The ID of the node.
+     */
+    [[nodiscard]] int at(int pos) const { return order[pos]; }
+    /**
+     * @brief Gets the position of a node.
+     * @param nodeId The ID of the node.
+     * @return The position.
+     */
+    [[nodiscard]] int getPos(int nodeId) const { return positions[nodeId]; }
+    /**
+     * @brief Gets the node visited after a node.
+     * @param nodeId The ID of the node.
+     * @return The ID of its successor.
+     */
+    [[nodiscard]] int next(int nodeId) const {
+        int pos = positions[nodeId] + 1;
+        return order[pos == (int) order.size() ? 0 : pos];
+    }
+    /**
+     * @brief Gets the node visited before a node.
+     * @param nodeId The ID of the node.
+     * @return The ID of its predecessor.
+     */
+    [[nodiscard]] int prev(int nodeId) const {
+        int pos = positions[nodeId];
+        return order[pos == 0 ? order.size() - 1 : pos - 1];
+    }
+    /**
+     * @brief Checks if b is on the path that goes forward from a to c (a, b and c included).
+     * @param a The ID of the first node.
+     * @param b The ID of the node checked.
+     * @param c The ID of the last node.
+     * @return true if it is, false otherwise.
+     */
+    [[nodiscard]] bool between(int a, int b, int c) const {
+        const int posA = positions[a], posB = positions[b], posC = positions[c];
+        if (posA <= posC) return posA <= posB && posB <= posC;
+        return posB >= posA || posB <= posC;
+    }
+    /**
+     * @brief Reverses the path that goes forward from one node to another (both included).
+     * @param from The ID of the first node of the path.
+     * @param to The ID of the last node of the path.
+     */
+    void reverse(int from, int to);
+    /**
+     * @brief Makes a 2-opt move: removes the edges (a, b) and (c, d) and adds (a, c) and (b, d).
+     *
+     * b must follow a and d follow c in the same direction (both forward or both backward), whichever way the tour
+     * is currently stored.
+     * @param a The ID of the first node of the first edge.
+     * @param b The ID of the second node of the first edge.
+     * @param c The ID of the first node of the second edge.
+     * @param d The ID of the second node of the second edge.
+     */
+    void twoOptMove(int a, int b, int c, int d) {
+        if (next(a) == b) reverse(b, c); // a b ... c d -> a c ... b d
+        else reverse(a, d); // b a ... d c -> b d ... a c
+    }
+    /**
+     * @brief Forgets the moves recorded so far and records the next ones, so that rollback() can undo them.
+     */
+    void checkpoint() {
+        journal.clear();
+        journaling = true;
+    }
+    /**
+     * @brief Undoes every move made since the last checkpoint, restoring the tour exactly as it was stored.
+     */
+    void rollback();
+    /**
+     * @brief Gets the visiting order, starting at the given node.
+     * @param startId The ID of the first node.
+     * @return The IDs of the nodes, in visiting order.
+     */
+    [[nodiscard]] std::vector<int> getOrder(int startId) const;
+};
+
+#endif //CITYNETWORK_TOUR_H
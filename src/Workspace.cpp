@@ -0,0 +1,33 @@
+#include "Workspace.h"
+
+using namespace std;
+
+void Workspace::reset(size_t size) {
+    visited.resize(size);
+    visited.reset();
+    parents.assign(size, -1);
+}
+
+WorkspaceArena::Lease WorkspaceArena::acquire(size_t size) {
+    unique_ptr<Workspace> workspace;
+    {
+        lock_guard<std::mutex> lock(mutex);
+        if (!available.empty()) {
+            workspace = std::move(available.back());
+            available.pop_back();
+        }
+    }
+    if (!workspace) workspace = make_unique<Workspace>();
+    workspace->reset(size);
+    return {this, std::move(workspace)};
+}
+
+void WorkspaceArena::release(unique_ptr<Workspace> workspace) {
+    lock_guard<std::mutex> lock(mutex);
+    available.push_back(std::move(workspace));
+}
+
+void WorkspaceArena::clear() {
+    lock_guard<std::mutex> lock(mutex);
+    available.clear();
+}
@@ -0,0 +1,80 @@
+#ifndef CITYNETWORK_WORKSPACE_H
+#define CITYNETWORK_WORKSPACE_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Bitset.h"
+#include "KdTree.h"
+
+/**
+ * @struct Workspace
+ * @brief The scratch state of one run of a solver, kept out of the graph so that it can be shared.
+ *
+ * Every array is indexed by node ID. A workspace is reused from run to run (see WorkspaceArena), so its arrays are
+ * only allocated when the graph grows, and clearing them costs O(V / 64) for the flags and O(V) for the others.
+ */
+struct Workspace {
+    Bitset visited; /**< Whether every node has been visited. */
+    std::vector<int> parents; /**< The parent of every node in a tree (e.g. the MST), -1 for none. */
+    std::vector<double> keys; /**< The cheapest edge from every node into a tree being grown (e.g. by Prim's algorithm). */
+    std::vector<double> row; /**< A row of distances, by destination ID. */
+    KdTree::Removals removals; /**< The nodes removed from the spatial index. */
+
+    /**
+     * @brief Sizes the flags and the parents for a number of node IDs, every node unvisited and without a parent.
+     * @param size The number of node IDs.
+     */
+    void reset(size_t size);
+};
+
+/**
+ * @class WorkspaceArena
+ * @brief A pool of workspaces, handed out to the runs of the solvers and taken back when they end.
+ *
+ * Any number of threads can acquire workspaces at once; each run gets its own. Copying an arena gives an empty one,
+ * so that the networks holding them can still be copied.
+ */
+class WorkspaceArena {
+    std::mutex mutex; /**< Guards available. */
+    std::vector<std::unique_ptr<Workspace>> available; /**< The workspaces not in use. */
+public:
+    /**
+     * @class Lease
+     * @brief A workspace in use, given back to its arena when the lease is destroyed.
+     */
+    class Lease {
+        WorkspaceArena* arena; /**< The arena the workspace goes back to. */
+        std::unique_ptr<Workspace> workspace; /**< The workspace. */
+    public:
+        Lease(WorkspaceArena* arena, std::unique_ptr<Workspace> workspace) : arena(arena), workspace(std::move(workspace)) {}
+        Lease(Lease&& other) noexcept = default;
+        Lease& operator=(Lease&&) = delete;
+        ~Lease() { if (workspace) arena->release(std::move(workspace)); }
+        Workspace& operator*() const { return *workspace; }
+        Workspace* operator->() const { return workspace.get(); }
+    };
+
+    WorkspaceArena() = default;
+    WorkspaceArena(const WorkspaceArena&) : WorkspaceArena() {}
+    WorkspaceArena& operator=(const WorkspaceArena&) { return *this; }
+
+    /**
+     * @brief Takes a workspace from the pool (a new one if it is empty) and resets it (see Workspace::reset()).
+     * @param size The number of node IDs.
+     * @return The lease of the workspace.
+     */
+    Lease acquire(size_t size);
+    /**
+     * @brief Puts a workspace back in the pool.
+     * @param workspace The workspace.
+     */
+    void release(std::unique_ptr<Workspace> workspace);
+    /**
+     * @brief Frees every workspace not in use (e.g. when the graph is reloaded).
+     */
+    void clear();
+};
+
+#endif //CITYNETWORK_WORKSPACE_H